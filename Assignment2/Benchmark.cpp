@@ -0,0 +1,267 @@
+// Times the loader, the searches, the statistics and reports of WeatherData and the Bst over
+// generated datasets of increasing size, and prints the median and 99th percentile of each
+// operation as JSON so that runs can be compared.
+// Build the Benchmark target of Assignment2.cbp, or on its own, for example:
+//   g++ -std=c++17 -O2 -pthread Benchmark.cpp $(ls *.cpp | grep -v -e MAIN.cpp -e Test.cpp -e Benchmark.cpp) -o benchmark
+// Usage: benchmark [--years 1,4,16] [--repeats N] [--output FILE]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "Bst.h"
+#include "DataProcessor.h"
+#include "TimeIndex.h"
+#include "Timestamp.h"
+#include "WeatherData.h"
+
+namespace {
+
+const int FIRST_YEAR = 2000; // The first year of every generated dataset
+const int BATCH = 1000; // The lookups timed together in one sample of the fast operations
+const char* const DATA_FILE = "benchmark_data.csv";
+const char* const REPORT_FILE = "benchmark_report.csv";
+
+// A stream buffer that accepts and drops everything, so printing is timed without a console
+class DiscardBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// The timings of one operation, per operation, in nanoseconds
+struct Result {
+    std::string name;
+    double median;
+    double p99;
+    double rowsPerSecond; // Rows handled per second at the median, or 0 when not meaningful
+    double megabytesPerSecond; // Bytes read per second at the median, or 0
+};
+
+// Time an operation over a number of samples; prepare runs before each sample and is not timed
+template <class Prepare, class Operation>
+Result Measure(const std::string& name, int repeats, int operations, Prepare prepare, Operation operation) {
+    std::vector<double> samples;
+    samples.reserve(repeats);
+    for (int i = 0; i < repeats; ++i) {
+        prepare();
+        auto start = std::chrono::steady_clock::now();
+        for (int j = 0; j < operations; ++j) {
+            operation(j);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        samples.push_back(elapsed.count() / operations);
+    }
+    std::sort(samples.begin(), samples.end());
+    std::size_t middle = samples.size() / 2;
+    double median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+    // Nearest rank: the smallest sample that at least 99% of the samples do not exceed
+    std::size_t rank = static_cast<std::size_t>(std::ceil(0.99 * samples.size()));
+    return Result{name, median, samples[rank - 1], 0, 0};
+}
+
+// Write a CSV file of ten-minute readings in the layout of the station files; returns its row count
+std::size_t WriteDataset(const std::string& path, int years) {
+    std::ofstream file(path);
+    file << "WAST,DP,Dta,Dts,EV,QFE,QFF,QNH,RF,RH,S,SR,ST1,ST2,ST3,ST4,Sx,T\n";
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> wind(0, 12);
+    std::uniform_int_distribution<int> solar(0, 1100);
+    std::uniform_int_distribution<int> temperature(500, 4200);
+    std::size_t rows = 0;
+    for (Timestamp t = MakeTimestamp(FIRST_YEAR, 1, 1); t < MakeTimestamp(FIRST_YEAR + years, 1, 1); t += 10) {
+        int year, month, day;
+        SplitTimestamp(t, year, month, day);
+        int minute = MinuteOfDay(t);
+        int hundredths = temperature(random);
+        char line[160];
+        std::snprintf(line, sizeof(line), "%d/%02d/%d %d:%02d,15.5,200,26,44.27,1007,1010.4,1010.6,0,63.6,%d,%d,26.1,29.2,28.2,26,10,%d.%02d\n",
+                      day, month, year, minute / 60, minute % 60, wind(random), solar(random),
+                      hundredths / 100, hundredths % 100);
+        file << line;
+        ++rows;
+    }
+    return rows;
+}
+
+// Write a number for JSON, which has no NaN or infinity
+void WriteNumber(std::ostream& out, double value) {
+    if (std::isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+void WriteResult(std::ostream& out, const Result& result, bool last) {
+    out << "        {\"name\": \"" << result.name << "\", \"unit\": \"ns\", \"median\": ";
+    WriteNumber(out, result.median);
+    out << ", \"p99\": ";
+    WriteNumber(out, result.p99);
+    if (result.rowsPerSecond > 0) {
+        out << ", \"rowsPerSecond\": ";
+        WriteNumber(out, result.rowsPerSecond);
+        out << ", \"megabytesPerSecond\": ";
+        WriteNumber(out, result.megabytesPerSecond);
+    }
+    out << "}" << (last ? "\n" : ",\n");
+}
+
+// Run every benchmark over one dataset; false if the data cannot be loaded or the indexes disagree
+bool RunDataset(int years, int repeats, std::ostream& json, bool last) {
+    std::size_t rows = WriteDataset(DATA_FILE, years);
+    std::ifstream sizeProbe(DATA_FILE, std::ios::binary | std::ios::ate);
+    double bytes = static_cast<double>(sizeProbe.tellg());
+    std::vector<Result> results;
+
+    // Each sample loads the whole file into a new processor
+    std::unique_ptr<DataProcessor> loaded;
+    bool ok = true;
+    Result load = Measure("DataLoader::LoadData", repeats, 1, [&loaded]() { loaded.reset(new DataProcessor()); },
+                          [&loaded, &ok](int) { ok = loaded->LoadData(DATA_FILE) && ok; });
+    load.rowsPerSecond = rows / (load.median * 1e-9);
+    load.megabytesPerSecond = bytes / 1e6 / (load.median * 1e-9);
+    results.push_back(load);
+    if (!ok) {
+        return false;
+    }
+
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> pickMonth(1, 12);
+    std::uniform_int_distribution<int> pickYear(FIRST_YEAR, FIRST_YEAR + years - 1);
+    std::vector<std::pair<int, int>> months(BATCH);
+    for (auto& month : months) {
+        month = std::make_pair(pickMonth(random), pickYear(random));
+    }
+    std::size_t found = 0;
+    results.push_back(Measure("DataProcessor::Search", repeats, BATCH, []() {}, [&](int i) {
+        found += loaded->Search(months[i].first, months[i].second).size();
+    }));
+
+    // The statistics run on cleared caches, so each sample computes and prints its result
+    WeatherData weatherData;
+    weatherData.LoadData(DATA_FILE);
+    DiscardBuffer discardBuffer;
+    std::ostream discard(&discardBuffer);
+    int month = 6;
+    int year = FIRST_YEAR + years / 2;
+    auto clear = [&weatherData]() { weatherData.ClearCache(); };
+    results.push_back(Measure("WeatherData::PrintAverageWindSpeed", repeats, 1, clear,
+                              [&](int) { weatherData.PrintAverageWindSpeed(month, year, discard); }));
+    results.push_back(Measure("WeatherData::PrintAverageTemperature", repeats, 1, clear,
+                              [&](int) { weatherData.PrintAverageTemperature(year, discard); }));
+    results.push_back(Measure("WeatherData::PrintSolarRadiation", repeats, 1, clear,
+                              [&](int) { weatherData.PrintSolarRadiation(year, discard); }));
+    results.push_back(Measure("WeatherData::PrintDiurnalProfile", repeats, 1, clear,
+                              [&](int) { weatherData.PrintDiurnalProfile(month, year, discard); }));
+    results.push_back(Measure("WeatherData::CalculateSPCC", repeats, 1, clear,
+                              [&](int) { weatherData.CalculateSPCC(month, discard); }));
+    results.push_back(Measure("WeatherData::WriteDataToFile", repeats, 1, clear,
+                              [&](int) { weatherData.WriteDataToFile(year, REPORT_FILE, discard); }));
+    std::remove(REPORT_FILE);
+
+    // The tree and the search index over every timestamp of the dataset
+    std::vector<Timestamp> timestamps;
+    for (int y = FIRST_YEAR; y < FIRST_YEAR + years; ++y) {
+        Span<const Timestamp> column = loaded->SelectYear(y).Timestamps();
+        timestamps.insert(timestamps.end(), column.begin(), column.end());
+    }
+    std::vector<Timestamp> shuffled(timestamps);
+    std::shuffle(shuffled.begin(), shuffled.end(), random);
+    std::uniform_int_distribution<std::size_t> pickRow(0, timestamps.size() - 1);
+    std::vector<Timestamp> queries(BATCH);
+    for (Timestamp& query : queries) {
+        query = timestamps[pickRow(random)] - 5;
+    }
+
+    std::unique_ptr<Bst<Timestamp>> tree;
+    results.push_back(Measure("Bst::insert", repeats, static_cast<int>(shuffled.size()),
+                              [&tree]() { tree.reset(new Bst<Timestamp>()); },
+                              [&tree, &shuffled](int i) { tree->insert(shuffled[i]); }));
+    results.push_back(Measure("Bst::search", repeats, BATCH, []() {},
+                              [&](int i) { found += tree->search(queries[i] + 5); }));
+    std::size_t treeSum = 0;
+    results.push_back(Measure("Bst::lowerBound", repeats, BATCH, [&treeSum]() { treeSum = 0; },
+                              [&](int i) { treeSum += static_cast<std::size_t>(*tree->lowerBound(queries[i])); }));
+
+    Span<const Timestamp> column(timestamps);
+    TimeIndex index;
+    index.Build(column);
+    std::size_t expected = 0;
+    std::size_t indexed = 0;
+    results.push_back(Measure("std::lower_bound", repeats, BATCH, [&expected]() { expected = 0; }, [&](int i) {
+        expected += static_cast<std::size_t>(std::lower_bound(timestamps.begin(), timestamps.end(), queries[i]) - timestamps.begin());
+    }));
+    results.push_back(Measure("TimeIndex::LowerBound", repeats, BATCH, [&indexed]() { indexed = 0; },
+                              [&](int i) { indexed += index.LowerBound(column, queries[i]); }));
+    std::remove(DATA_FILE);
+
+    json << "    {\n      \"years\": " << years << ",\n      \"rows\": " << rows << ",\n      \"bytes\": "
+         << static_cast<std::uint64_t>(bytes) << ",\n      \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        WriteResult(json, results[i], i + 1 == results.size());
+    }
+    json << "      ]\n    }" << (last ? "\n" : ",\n");
+    // The lookups are checked so that they cannot be optimised away and the index stays correct
+    return indexed == expected && found > 0 && treeSum > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes = {1, 4, 16};
+    int repeats = 21;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--years" && i + 1 < argc) {
+            // The number of years of each dataset, such as 1,4,16
+            sizes.clear();
+            std::stringstream list(argv[++i]);
+            std::string size;
+            while (getline(list, size, ',')) {
+                sizes.push_back(std::max(1, std::stoi(size)));
+            }
+        } else if (argument == "--repeats" && i + 1 < argc) {
+            repeats = std::max(1, std::stoi(argv[++i]));
+        } else if (argument == "--output" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--years 1,4,16] [--repeats N] [--output FILE]\n";
+            return 1;
+        }
+    }
+
+    // The loader prints to the console; only the JSON is written
+    std::streambuf* console = std::cout.rdbuf();
+    DiscardBuffer discardBuffer;
+    std::cout.rdbuf(&discardBuffer);
+    std::ofstream outputFile;
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath);
+    }
+    std::ostream consoleOut(console);
+    std::ostream& json = outputPath.empty() ? consoleOut : outputFile;
+
+    json << std::fixed << std::setprecision(1);
+    json << "{\n  \"benchmark\": \"Assignment2\",\n  \"repeats\": " << repeats << ",\n  \"datasets\": [\n";
+    bool ok = true;
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        ok = RunDataset(sizes[i], repeats, json, i + 1 == sizes.size()) && ok;
+    }
+    json << "  ]\n}\n";
+    std::cout.rdbuf(console);
+    if (!ok) {
+        std::cerr << "A benchmark failed to load its data or its lookups disagree\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -1,10 +1,33 @@
 #ifndef BST_H
 #define BST_H
 
+#include <cstddef>
 #include <iostream>
-#include <stdexcept> // Added for std::logic_error
-#include "Date.h" // Added for Date class
-
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "NodePool.h"
+
+/**
+ * @brief An ordered index kept balanced as an AVL tree.
+ *
+ * The heights of the two subtrees of every node differ by at most one, so the height of a
+ * tree of n values is below 1.45 log2(n) and insert, search, remove and lowerBound take
+ * O(log n) even when the values arrive in order, such as timestamps. Every operation is
+ * iterative, so a large tree cannot overflow the stack. Equal values are allowed and are
+ * kept in insertion order.
+ *
+ * Values are only compared with operator<. Traversals pass each value to a visitor, and
+ * const_iterator walks the values in order through parent links.
+ *
+ * Nodes are taken from a NodePool owned by the tree, so a tree of n values costs a few
+ * dozen heap allocations at most, and a tree built from a sorted range or copied costs one.
+ * Clearing the tree frees every slab at once. Moving a tree moves its pool, so no node
+ * is copied.
+ *
+ * @tparam T The value type.
+ */
 template <class T>
 class Bst {
 private:
@@ -12,241 +35,621 @@ private:
         T data;
         Node* left;
         Node* right;
+        Node* parent;
+        int height; // The number of nodes on the longest path down to a leaf, 1 for a leaf
 
-        Node(const T& value) : data(value), left(nullptr), right(nullptr) {}
+        Node(const T& value, Node* parentNode) : data(value), left(nullptr), right(nullptr), parent(parentNode), height(1) {}
     };
 
     Node* root;
-
-    // Private helper functions for recursive operations
-    void insertRecursive(Node*& node, const T& value);
-    void inOrderTraversalRecursive(Node* node) const;
-    void preOrderTraversalRecursive(Node* node) const;
-    void postOrderTraversalRecursive(Node* node) const;
-    bool searchRecursive(Node* node, const T& value) const;
-    void removeRecursive(Node*& node, const T& value);
-    void deleteTreeRecursive(Node*& node);
-    void copyRecursive(Node*& currentNode, const Node* otherNode); // Added function for deep copy
-
-    // Added declaration of findMin function
-    Node* findMin(Node* node) const;
+    std::size_t count; // The number of values in the tree
+    NodePool<Node> pool; // The slabs every node of the tree lives in
+
+    // Balancing helpers
+    static int heightOf(const Node* node) { return node == nullptr ? 0 : node->height; }
+    static int balanceOf(const Node* node) { return heightOf(node->left) - heightOf(node->right); }
+    static void updateHeight(Node* node);
+    void replaceChild(Node* parent, Node* oldChild, Node* newChild);
+    Node* rotateLeft(Node* node);
+    Node* rotateRight(Node* node);
+    void rebalanceFrom(Node* node);
+
+    // Navigation helpers
+    static const Node* leftmost(const Node* node);
+    static const Node* successor(const Node* node);
+    Node* findNode(const T& value) const;
+    const Node* lowerBoundNode(const T& value) const;
+
+    // Whole-tree helpers
+    Node* copyTree(const Node* other);
+    void deleteSubtree(Node* node);
 
 public:
+    /**
+     * @brief A read-only iterator over the values of the tree in ascending order.
+     */
+    class const_iterator {
+    private:
+        const Node* node; // The current node, nullptr at the end
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        explicit const_iterator(const Node* current = nullptr) : node(current) {}
+        const T& operator*() const { return node->data; }
+        const T* operator->() const { return &node->data; }
+        const_iterator& operator++() { node = successor(node); return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; node = successor(node); return old; }
+        bool operator==(const const_iterator& other) const { return node == other.node; }
+        bool operator!=(const const_iterator& other) const { return node != other.node; }
+    };
+
     // Constructors and destructor
     Bst();
     Bst(const Bst& other); // Copy constructor
+    Bst(Bst&& other) noexcept; // Move constructor
     Bst& operator=(const Bst& other); // Assignment operator
+    Bst& operator=(Bst&& other) noexcept; // Move assignment operator
     ~Bst();
 
-    // Public member functions
+    /**
+     * @brief Construct a perfectly balanced tree from a sorted range in O(n).
+     *
+     * @param first The first value of the range.
+     * @param last One past the last value. The values must be in ascending order; equal values keep their order.
+     */
+    template <class Iterator>
+    Bst(Iterator first, Iterator last);
+
+    /**
+     * @brief Replace every value with a sorted range, building a perfectly balanced tree in O(n).
+     *
+     * All nodes are created in one slab and linked by splitting the range at its middle,
+     * so no comparison or rotation is made.
+     *
+     * @param first The first value of the range.
+     * @param last One past the last value. The values must be in ascending order; equal values keep their order.
+     */
+    template <class Iterator>
+    void assignSorted(Iterator first, Iterator last);
+
+    /**
+     * @brief Exchange the values of two trees in O(1).
+     * @param other The tree to be swapped with.
+     */
+    void swap(Bst& other) noexcept;
+
+    /**
+     * @brief Insert a value, after any values equal to it. O(log n).
+     * @param value The value to be inserted.
+     */
     void insert(const T& value);
-    void inOrderTraversal() const;
-    void preOrderTraversal() const;
-    void postOrderTraversal() const;
+
+    /**
+     * @brief Check if a value equal to the given one is in the tree. O(log n).
+     * @param value The value to be found.
+     * @return true If an equal value is found.
+     */
     bool search(const T& value) const;
+
+    /**
+     * @brief Remove one value equal to the given one, if there is any. O(log n).
+     * @param value The value to be removed.
+     */
     void remove(const T& value);
+
+    /**
+     * @brief Remove every value.
+     */
     void deleteTree();
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Get the number of slabs allocated for nodes.
+     * @return std::size_t The number of heap allocations held by the tree.
+     */
+    std::size_t slabCount() const { return pool.SlabCount(); }
+
+    /**
+     * @brief Get the height of the tree.
+     * @return int The number of nodes on the longest path from the root to a leaf, 0 if empty.
+     */
+    int height() const { return heightOf(root); }
+
+    const_iterator begin() const { return const_iterator(leftmost(root)); }
+    const_iterator end() const { return const_iterator(); }
+
+    /**
+     * @brief Find the first value that is not less than a given value. O(log n).
+     * @param value The value to be compared.
+     * @return const_iterator The first value >= value, or end() if there is none.
+     */
+    const_iterator lowerBound(const T& value) const;
+
+    /**
+     * @brief Visit every value in [lo, hi) in ascending order. O(log n + k) for k values.
+     *
+     * @param lo The smallest value to be visited.
+     * @param hi The value at which the visit stops, not included.
+     * @param visit A function called with each value as a const T&.
+     */
+    template <class Visitor>
+    void range(const T& lo, const T& hi, Visitor visit) const;
+
+    /**
+     * @brief Visit the values in order (left, node, right).
+     * @param visit A function called with each value as a const T&.
+     */
+    template <class Visitor>
+    void inOrderTraversal(Visitor visit) const;
+
+    /**
+     * @brief Visit the values in pre-order (node, left, right).
+     * @param visit A function called with each value as a const T&.
+     */
+    template <class Visitor>
+    void preOrderTraversal(Visitor visit) const;
+
+    /**
+     * @brief Visit the values in post-order (left, right, node).
+     * @param visit A function called with each value as a const T&.
+     */
+    template <class Visitor>
+    void postOrderTraversal(Visitor visit) const;
+
+    // Print the values to std::cout, separated by spaces
+    void inOrderTraversal() const;
+    void preOrderTraversal() const;
+    void postOrderTraversal() const;
 };
 
-#include "Bst.cpp"
+// Constructors and destructor
+template <class T>
+Bst<T>::Bst() : root(nullptr), count(0), pool() {}
 
-// Implementation of the copy constructor
 template <class T>
-Bst<T>::Bst(const Bst& other) : root(nullptr) {
-    // Call the recursive function to perform deep copy
-    insertRecursive(this->root, other.root->data);
-    copyRecursive(this->root, other.root);
+Bst<T>::Bst(const Bst& other) : root(nullptr), count(0), pool() {
+    pool.Reserve(other.count);
+    root = copyTree(other.root);
+    count = other.count;
 }
 
-// Recursive function for deep copy
 template <class T>
-void Bst<T>::copyRecursive(Node*& currentNode, const Node* otherNode) {
-    if (otherNode != nullptr) {
-        insertRecursive(currentNode, otherNode->data);
-        copyRecursive(currentNode->left, otherNode->left);
-        copyRecursive(currentNode->right, otherNode->right);
-    }
+Bst<T>::Bst(Bst&& other) noexcept : Bst() {
+    swap(other);
 }
 
-// Implementation of the assignment operator
+template <class T>
+template <class Iterator>
+Bst<T>::Bst(Iterator first, Iterator last) : Bst() {
+    assignSorted(first, last);
+}
+
+// Copy first, so this tree is left unchanged if copying fails
 template <class T>
 Bst<T>& Bst<T>::operator=(const Bst& other) {
     if (this != &other) {
-        // Delete the existing tree
-        deleteTreeRecursive(this->root);
+        Bst copy(other);
+        swap(copy);
+    }
+    return *this;
+}
 
-        // Perform deep copy
-        insertRecursive(this->root, other.root->data);
-        copyRecursive(this->root, other.root);
+// The old values are freed with the temporary that takes them over
+template <class T>
+Bst<T>& Bst<T>::operator=(Bst&& other) noexcept {
+    if (this != &other) {
+        Bst moved(std::move(other));
+        swap(moved);
     }
     return *this;
 }
 
-// Recursive insert operation
 template <class T>
-void Bst<T>::insertRecursive(Node*& node, const T& value) {
-    if (node == nullptr) {
-        node = new Node(value);
+Bst<T>::~Bst() {
+    deleteTree();
+}
+
+template <class T>
+void Bst<T>::swap(Bst& other) noexcept {
+    std::swap(root, other.root);
+    std::swap(count, other.count);
+    pool.Swap(other.pool);
+}
+
+template <class T>
+void Bst<T>::updateHeight(Node* node) {
+    int left = heightOf(node->left);
+    int right = heightOf(node->right);
+    node->height = (left > right ? left : right) + 1;
+}
+
+// Point the parent (or the root) at a new child in place of an old one
+template <class T>
+void Bst<T>::replaceChild(Node* parent, Node* oldChild, Node* newChild) {
+    if (parent == nullptr) {
+        root = newChild;
+    } else if (parent->left == oldChild) {
+        parent->left = newChild;
     } else {
+        parent->right = newChild;
+    }
+}
+
+// Lift the right child of a node into its place and return it
+template <class T>
+typename Bst<T>::Node* Bst<T>::rotateLeft(Node* node) {
+    Node* pivot = node->right;
+    node->right = pivot->left;
+    if (pivot->left != nullptr) {
+        pivot->left->parent = node;
+    }
+    pivot->parent = node->parent;
+    replaceChild(node->parent, node, pivot);
+    pivot->left = node;
+    node->parent = pivot;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+// Lift the left child of a node into its place and return it
+template <class T>
+typename Bst<T>::Node* Bst<T>::rotateRight(Node* node) {
+    Node* pivot = node->left;
+    node->left = pivot->right;
+    if (pivot->right != nullptr) {
+        pivot->right->parent = node;
+    }
+    pivot->parent = node->parent;
+    replaceChild(node->parent, node, pivot);
+    pivot->right = node;
+    node->parent = pivot;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+// Walk from a changed node up to the root, fixing heights and rotating any node out of balance
+template <class T>
+void Bst<T>::rebalanceFrom(Node* node) {
+    while (node != nullptr) {
+        updateHeight(node);
+        int balance = balanceOf(node);
+        if (balance > 1) {
+            if (balanceOf(node->left) < 0) {
+                rotateLeft(node->left);
+            }
+            node = rotateRight(node);
+        } else if (balance < -1) {
+            if (balanceOf(node->right) > 0) {
+                rotateRight(node->right);
+            }
+            node = rotateLeft(node);
+        }
+        node = node->parent;
+    }
+}
+
+template <class T>
+const typename Bst<T>::Node* Bst<T>::leftmost(const Node* node) {
+    while (node != nullptr && node->left != nullptr) {
+        node = node->left;
+    }
+    return node;
+}
+
+// The next node in order is the leftmost of the right subtree, or the first ancestor reached from its left
+template <class T>
+const typename Bst<T>::Node* Bst<T>::successor(const Node* node) {
+    if (node->right != nullptr) {
+        return leftmost(node->right);
+    }
+    while (node->parent != nullptr && node->parent->right == node) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+template <class T>
+typename Bst<T>::Node* Bst<T>::findNode(const T& value) const {
+    Node* node = root;
+    while (node != nullptr) {
         if (value < node->data) {
-            insertRecursive(node->left, value);
+            node = node->left;
+        } else if (node->data < value) {
+            node = node->right;
         } else {
-            insertRecursive(node->right, value);
+            return node;
         }
     }
+    return nullptr;
 }
 
-// Recursive in-order traversal
 template <class T>
-void Bst<T>::inOrderTraversalRecursive(Node* node) const {
-    if (node != nullptr) {
-        inOrderTraversalRecursive(node->left);
-        std::cout << node->data << " ";
-        inOrderTraversalRecursive(node->right);
+const typename Bst<T>::Node* Bst<T>::lowerBoundNode(const T& value) const {
+    const Node* node = root;
+    const Node* bound = nullptr;
+    while (node != nullptr) {
+        if (node->data < value) {
+            node = node->right;
+        } else {
+            bound = node;
+            node = node->left;
+        }
     }
+    return bound;
 }
 
-// Recursive pre-order traversal
+// Copy a tree in pre-order, walking the source and the copy together through parent links
 template <class T>
-void Bst<T>::preOrderTraversalRecursive(Node* node) const {
-    if (node != nullptr) {
-        std::cout << node->data << " ";
-        preOrderTraversalRecursive(node->left);
-        preOrderTraversalRecursive(node->right);
+typename Bst<T>::Node* Bst<T>::copyTree(const Node* other) {
+    if (other == nullptr) {
+        return nullptr;
+    }
+
+    Node* copy = pool.Create(other->data, nullptr);
+    copy->height = other->height;
+    try {
+        const Node* source = other;
+        Node* target = copy;
+        while (true) {
+            if (source->left != nullptr && target->left == nullptr) {
+                target->left = pool.Create(source->left->data, target);
+                source = source->left;
+                target = target->left;
+            } else if (source->right != nullptr && target->right == nullptr) {
+                target->right = pool.Create(source->right->data, target);
+                source = source->right;
+                target = target->right;
+            } else if (source != other) {
+                source = source->parent;
+                target = target->parent;
+                continue;
+            } else {
+                break;
+            }
+            target->height = source->height;
+        }
+    } catch (...) {
+        deleteSubtree(copy);
+        throw;
     }
+    return copy;
 }
 
-// Recursive post-order traversal
+// Rotate left children up until the node has none, then destroy it and carry on down the right
 template <class T>
-void Bst<T>::postOrderTraversalRecursive(Node* node) const {
-    if (node != nullptr) {
-        postOrderTraversalRecursive(node->left);
-        postOrderTraversalRecursive(node->right);
-        std::cout << node->data << " ";
+void Bst<T>::deleteSubtree(Node* node) {
+    while (node != nullptr) {
+        if (node->left != nullptr) {
+            Node* left = node->left;
+            node->left = left->right;
+            left->right = node;
+            node = left;
+        } else {
+            Node* right = node->right;
+            pool.Destroy(node);
+            node = right;
+        }
     }
 }
 
-// Recursive search operation
+// Public member functions
 template <class T>
-bool Bst<T>::searchRecursive(Node* node, const T& value) const {
-    if (node == nullptr) {
-        return false;
+void Bst<T>::insert(const T& value) {
+    Node* parent = nullptr;
+    Node* node = root;
+    while (node != nullptr) {
+        parent = node;
+        node = value < node->data ? node->left : node->right;
     }
 
-    if (value == node->data) {
-        return true;
-    } else if (value < node->data) {
-        return searchRecursive(node->left, value);
+    Node* added = pool.Create(value, parent);
+    if (parent == nullptr) {
+        root = added;
+    } else if (value < parent->data) {
+        parent->left = added;
     } else {
-        return searchRecursive(node->right, value);
+        parent->right = added;
     }
+    ++count;
+    rebalanceFrom(parent);
+}
 
-    // Added a return statement or an exception at the end of the function
-    // return false;
-    throw std::logic_error("Invalid state in searchRecursive function");
+// Search for a value in the binary search tree
+template <class T>
+bool Bst<T>::search(const T& value) const {
+    return findNode(value) != nullptr;
 }
 
-// Recursive remove operation
+// Remove a value from the binary search tree
 template <class T>
-void Bst<T>::removeRecursive(Node*& node, const T& value) {
+void Bst<T>::remove(const T& value) {
+    Node* node = findNode(value);
     if (node == nullptr) {
         return;
     }
 
-    if (value < node->data) {
-        removeRecursive(node->left, value);
-    } else if (value > node->data) {
-        removeRecursive(node->right, value);
-    } else {
-        if (node->left == nullptr) {
-            Node* temp = node;
-            node = node->right;
-            delete temp;
-        } else if (node->right == nullptr) {
-            Node* temp = node;
-            node = node->left;
-            delete temp;
-        } else {
-            Node* temp = findMin(node->right);
-            node->data = temp->data;
-            removeRecursive(node->right, temp->data);
+    // A node with two children takes the value of the next node in order, which has no left child
+    if (node->left != nullptr && node->right != nullptr) {
+        Node* next = node->right;
+        while (next->left != nullptr) {
+            next = next->left;
         }
+        node->data = next->data;
+        node = next;
     }
+
+    Node* child = node->left != nullptr ? node->left : node->right;
+    Node* parent = node->parent;
+    if (child != nullptr) {
+        child->parent = parent;
+    }
+    replaceChild(parent, node, child);
+    pool.Destroy(node);
+    --count;
+    rebalanceFrom(parent);
 }
 
-// Recursive delete tree operation
+// Delete the entire binary search tree, visiting the nodes only if their values need destroying
 template <class T>
-void Bst<T>::deleteTreeRecursive(Node*& node) {
-    if (node != nullptr) {
-        deleteTreeRecursive(node->left);
-        deleteTreeRecursive(node->right);
-        delete node;
-        node = nullptr;
+void Bst<T>::deleteTree() {
+    if (!std::is_trivially_destructible<T>::value) {
+        deleteSubtree(root);
     }
+    pool.Clear();
+    root = nullptr;
+    count = 0;
 }
 
-// Constructors and destructor
+// Create the nodes in order, then link each range of nodes under its middle one
 template <class T>
-Bst<T>::Bst() : root(nullptr) {}
+template <class Iterator>
+void Bst<T>::assignSorted(Iterator first, Iterator last) {
+    Bst sorted;
+    std::vector<Node*> nodes;
+    nodes.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    sorted.pool.Reserve(nodes.capacity());
+    try {
+        for (; first != last; ++first) {
+            nodes.push_back(sorted.pool.Create(*first, nullptr));
+        }
+    } catch (...) {
+        for (Node* node : nodes) {
+            sorted.pool.Destroy(node);
+        }
+        throw;
+    }
 
-template <class T>
-Bst<T>::~Bst() {
-    // Implementation...
+    struct Range {
+        std::size_t begin; // The first node of the range
+        std::size_t end; // One past the last node of the range
+        Node* parent; // The node the middle of the range hangs from
+        bool left; // True if the middle is the left child of parent
+    };
+    std::vector<Range> pending;
+    if (!nodes.empty()) {
+        pending.push_back(Range{0, nodes.size(), nullptr, true});
+    }
+    while (!pending.empty()) {
+        Range range = pending.back();
+        pending.pop_back();
+        std::size_t middle = range.begin + (range.end - range.begin) / 2;
+        Node* node = nodes[middle];
+        node->parent = range.parent;
+        if (range.parent == nullptr) {
+            sorted.root = node;
+        } else if (range.left) {
+            range.parent->left = node;
+        } else {
+            range.parent->right = node;
+        }
+        // The halves differ in size by at most one, so the height is the bit length of the size
+        int height = 0;
+        for (std::size_t size = range.end - range.begin; size != 0; size >>= 1) {
+            ++height;
+        }
+        node->height = height;
+        if (range.begin < middle) {
+            pending.push_back(Range{range.begin, middle, node, true});
+        }
+        if (middle + 1 < range.end) {
+            pending.push_back(Range{middle + 1, range.end, node, false});
+        }
+    }
+    sorted.count = nodes.size();
+    swap(sorted);
 }
 
-// Public member functions
 template <class T>
-void Bst<T>::insert(const T& value) {
-    insertRecursive(root, value);
+typename Bst<T>::const_iterator Bst<T>::lowerBound(const T& value) const {
+    return const_iterator(lowerBoundNode(value));
 }
 
-// Perform in-order traversal of the binary search tree
 template <class T>
-void Bst<T>::inOrderTraversal() const {
-    inOrderTraversalRecursive(root);
-    std::cout << std::endl;
+template <class Visitor>
+void Bst<T>::range(const T& lo, const T& hi, Visitor visit) const {
+    for (const Node* node = lowerBoundNode(lo); node != nullptr && node->data < hi; node = successor(node)) {
+        visit(node->data);
+    }
 }
 
-// Perform pre-order traversal of the binary search tree
 template <class T>
-void Bst<T>::preOrderTraversal() const {
-    preOrderTraversalRecursive(root);
-    std::cout << std::endl;
+template <class Visitor>
+void Bst<T>::inOrderTraversal(Visitor visit) const {
+    for (const Node* node = leftmost(root); node != nullptr; node = successor(node)) {
+        visit(node->data);
+    }
 }
 
-// Perform post-order traversal of the binary search tree
+// Visit each node before its subtrees, keeping the right subtrees still to be visited on a stack
 template <class T>
-void Bst<T>::postOrderTraversal() const {
-    postOrderTraversalRecursive(root);
-    std::cout << std::endl;
+template <class Visitor>
+void Bst<T>::preOrderTraversal(Visitor visit) const {
+    std::vector<const Node*> pending;
+    if (root != nullptr) {
+        pending.push_back(root);
+    }
+    while (!pending.empty()) {
+        const Node* node = pending.back();
+        pending.pop_back();
+        visit(node->data);
+        if (node->right != nullptr) {
+            pending.push_back(node->right);
+        }
+        if (node->left != nullptr) {
+            pending.push_back(node->left);
+        }
+    }
 }
 
-// Search for a value in the binary search tree
+// Visit each node after its subtrees, moving through parent links and remembering where we came from
 template <class T>
-bool Bst<T>::search(const T& value) const {
-    return searchRecursive(root, value);
+template <class Visitor>
+void Bst<T>::postOrderTraversal(Visitor visit) const {
+    const Node* node = root;
+    const Node* previous = nullptr;
+    while (node != nullptr) {
+        if (previous == node->parent && node->left != nullptr) {
+            previous = node;
+            node = node->left;
+        } else if ((previous == node->parent || previous == node->left) && node->right != nullptr) {
+            previous = node;
+            node = node->right;
+        } else {
+            visit(node->data);
+            previous = node;
+            node = node->parent;
+        }
+    }
 }
 
-// Remove a value from the binary search tree
+// Perform in-order traversal of the binary search tree
 template <class T>
-void Bst<T>::remove(const T& value) {
-    removeRecursive(root, value);
+void Bst<T>::inOrderTraversal() const {
+    inOrderTraversal([](const T& value) { std::cout << value << " "; });
+    std::cout << std::endl;
 }
 
-// Delete the entire binary search tree
+// Perform pre-order traversal of the binary search tree
 template <class T>
-void Bst<T>::deleteTree() {
-    deleteTreeRecursive(root);
+void Bst<T>::preOrderTraversal() const {
+    preOrderTraversal([](const T& value) { std::cout << value << " "; });
+    std::cout << std::endl;
 }
+
+// Perform post-order traversal of the binary search tree
 template <class T>
-typename Bst<T>::Node* Bst<T>::findMin(Node* node) const {
-    if (node == nullptr) {
-        return nullptr;
-    } else if (node->left == nullptr) {
-        return node;
-    } else {
-        return findMin(node->left);
-    }
+void Bst<T>::postOrderTraversal() const {
+    postOrderTraversal([](const T& value) { std::cout << value << " "; });
+    std::cout << std::endl;
 }
 
 #endif // BST_H
@@ -0,0 +1,162 @@
+#include "ColumnPlan.h"
+#include "DataLoader.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// Skip the leading whitespace that std::stoi and std::stod would skip
+const char* SkipSpaces(const char* first, const char* last) {
+    while (first != last && (*first == ' ' || *first == '\t' || *first == '\r' || *first == '\n' || *first == '\v' || *first == '\f')) {
+        ++first;
+    }
+    return first;
+}
+
+// Parse an integer prefix the way std::stoi does; returns false where std::stoi would throw
+bool ParseInt(const char* first, const char* last, int& value) {
+    first = SkipSpaces(first, last);
+    if (first != last && *first == '+') {
+        ++first;
+        if (first != last && *first == '-') {
+            return false;
+        }
+    }
+    std::from_chars_result result = std::from_chars(first, last, value);
+    return result.ec == std::errc();
+}
+
+// Parse a floating point prefix the way std::stod does; returns false where std::stod would throw
+bool ParseDouble(const char* first, const char* last, double& value) {
+    first = SkipSpaces(first, last);
+    if (first != last && *first == '+') {
+        ++first;
+        if (first != last && *first == '-') {
+            return false;
+        }
+    }
+    std::from_chars_result result = std::from_chars(first, last, value);
+    return result.ec == std::errc();
+}
+
+// Parse a sensor field: an empty or unreadable field is stored as 0.0
+double ParseMeasurement(const char* first, const char* last) {
+    double value = 0.0;
+    if (first == last || !ParseDouble(first, last, value)) {
+        return 0.0;
+    }
+    return value;
+}
+
+// Find the end of the next getline-style token that stops at delimiter
+const char* TokenEnd(const char* first, const char* last, char delimiter) {
+    if (first == last) {
+        return last;
+    }
+    const void* found = std::memchr(first, delimiter, static_cast<std::size_t>(last - first));
+    return found != nullptr ? static_cast<const char*>(found) : last;
+}
+
+// Parse the "h:mm" time after the date; a missing or unreadable time is read as midnight
+void ParseTime(const char* first, const char* last, MonthData& monthData) {
+    const char* hourEnd = TokenEnd(first, last, ':');
+    if (hourEnd == last || !ParseInt(first, hourEnd, monthData.m_hour) || !ParseInt(hourEnd + 1, last, monthData.m_minute)
+        || monthData.m_hour < 0 || monthData.m_hour > 23 || monthData.m_minute < 0 || monthData.m_minute > 59) {
+        monthData.m_hour = 0;
+        monthData.m_minute = 0;
+    }
+}
+
+// Parse a WAST field such as "1/01/2007 9:00" into day, month, year, hour and minute
+void ParseDate(const char* first, const char* last, MonthData& monthData) {
+    const char* dayEnd = TokenEnd(first, last, '/');
+    const char* monthBegin = dayEnd == last ? last : dayEnd + 1;
+    const char* monthEnd = TokenEnd(monthBegin, last, '/');
+    const char* yearBegin = monthEnd == last ? last : monthEnd + 1;
+    const char* yearEnd = TokenEnd(yearBegin, last, ' ');
+
+    if (!ParseInt(first, dayEnd, monthData.m_day)
+        || !ParseInt(monthBegin, monthEnd, monthData.m_month)
+        || !ParseInt(yearBegin, yearEnd, monthData.m_year)) {
+        monthData.m_day = 0;
+        monthData.m_month = 0;
+        monthData.m_year = 0;
+    }
+    ParseTime(yearEnd == last ? last : yearEnd + 1, last, monthData);
+}
+
+} // namespace
+
+ColumnPlan::ColumnPlan() : m_sinks(), m_columnCount(0), m_hasDate(false) {}
+
+// Resolve each header column to the action taken for its fields
+ColumnPlan ColumnPlan::Compile(std::string_view header, unsigned columns) {
+    ColumnPlan plan;
+    std::size_t lastNeeded = 0;
+
+    const char* last = header.data() + header.size();
+    for (const char* field = header.data(); field != last;) {
+        const char* fieldEnd = TokenEnd(field, last, ',');
+        std::string_view columnName(field, static_cast<std::size_t>(fieldEnd - field));
+
+        Sink sink = Sink::Skip;
+        if (columnName == "WAST") {
+            sink = Sink::Date;
+            plan.m_hasDate = true;
+        } else if (columnName == "S" && (columns & SENSOR_WIND_SPEED)) {
+            sink = Sink::WindSpeed;
+        } else if (columnName == "T" && (columns & SENSOR_TEMPERATURE)) {
+            sink = Sink::Temperature;
+        } else if (columnName == "SR" && (columns & SENSOR_SOLAR_RADIATION)) {
+            sink = Sink::SolarRadiation;
+        }
+
+        plan.m_sinks.push_back(sink);
+        plan.m_columnCount++;
+        if (sink != Sink::Skip) {
+            lastNeeded = plan.m_columnCount;
+        }
+
+        field = fieldEnd == last ? fieldEnd : fieldEnd + 1;
+    }
+
+    // Nothing after the last needed column is ever read
+    plan.m_sinks.resize(lastNeeded);
+    return plan;
+}
+
+// Parse the needed fields of a line; fields are split on commas like std::getline
+bool ColumnPlan::ParseLine(const char* first, const char* last, MonthData& monthData) const {
+    monthData = MonthData{};
+    if (!m_hasDate) {
+        return false;
+    }
+
+    std::size_t index = 0;
+    const std::size_t needed = m_sinks.size();
+    for (const char* field = first; field != last && index < needed; ++index) {
+        const char* fieldEnd = TokenEnd(field, last, ',');
+
+        switch (m_sinks[index]) {
+            case Sink::Skip:
+                break;
+            case Sink::Date:
+                ParseDate(field, fieldEnd, monthData);
+                break;
+            case Sink::WindSpeed:
+                monthData.m_windSpeed = ParseMeasurement(field, fieldEnd);
+                break;
+            case Sink::Temperature:
+                monthData.m_temperature = ParseMeasurement(field, fieldEnd);
+                break;
+            case Sink::SolarRadiation:
+                monthData.m_solarRadiation = ParseMeasurement(field, fieldEnd);
+                break;
+        }
+
+        field = fieldEnd == last ? last : fieldEnd + 1;
+    }
+
+    return index >= needed && IsValidDate(monthData.m_year, monthData.m_month, monthData.m_day);
+}
@@ -0,0 +1,97 @@
+#ifndef COLUMNPLAN_H
+#define COLUMNPLAN_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+struct MonthData;
+
+/**
+ * @brief Flags that select which sensor columns the loader converts.
+ *
+ * The WAST date column is always loaded. Sensor columns that are not selected are skipped
+ * without being converted and their MonthData fields are left at 0.0.
+ */
+enum SensorColumn : unsigned {
+    SENSOR_NONE = 0,
+    SENSOR_WIND_SPEED = 1u << 0, // The S column
+    SENSOR_TEMPERATURE = 1u << 1, // The T column
+    SENSOR_SOLAR_RADIATION = 1u << 2, // The SR column
+    SENSOR_ALL = SENSOR_WIND_SPEED | SENSOR_TEMPERATURE | SENSOR_SOLAR_RADIATION
+};
+
+/**
+ * @brief A parse plan compiled once from the header line of a CSV file.
+ *
+ * The files do not agree on column order, so the header is resolved into one action per
+ * column position. Parsing a row then needs no string comparisons: each field is either
+ * converted into its MonthData member or skipped, and the line is abandoned as soon as the
+ * last needed column has been read.
+ */
+class ColumnPlan {
+public:
+    /**
+     * @brief The action taken for the field at a given column position.
+     */
+    enum class Sink : unsigned char {
+        Skip,
+        Date,
+        WindSpeed,
+        Temperature,
+        SolarRadiation
+    };
+
+private:
+    std::vector<Sink> m_sinks; // One action per column position, up to the last needed column
+    std::size_t m_columnCount; // The number of columns in the header
+    bool m_hasDate; // True if the header has a WAST column
+
+public:
+    /**
+     * @brief Construct an empty plan that accepts no rows.
+     */
+    ColumnPlan();
+
+    /**
+     * @brief Compile a plan from a header line.
+     *
+     * @param header The header line, without its line terminator.
+     * @param columns The SensorColumn flags of the sensors to be loaded.
+     * @return ColumnPlan The compiled plan.
+     */
+    static ColumnPlan Compile(std::string_view header, unsigned columns = SENSOR_ALL);
+
+    /**
+     * @brief Parse one data line into a MonthData record.
+     *
+     * The record is reset first, so sensors that are not loaded read as 0.0.
+     *
+     * @param first The first byte of the line.
+     * @param last One past the last byte of the line, excluding the '\n'.
+     * @param monthData The record that receives the parsed fields.
+     * @return true If the line has every needed column and a valid date.
+     * @return false If the line should be skipped.
+     */
+    bool ParseLine(const char* first, const char* last, MonthData& monthData) const;
+
+    /**
+     * @brief Get the number of columns in the header.
+     * @return std::size_t The column count.
+     */
+    std::size_t ColumnCount() const { return m_columnCount; }
+
+    /**
+     * @brief Get the number of columns read from each line.
+     * @return std::size_t The position of the last needed column plus one.
+     */
+    std::size_t NeededColumnCount() const { return m_sinks.size(); }
+
+    /**
+     * @brief Check if the header has a WAST column, without which no row can be loaded.
+     * @return true If the plan can load rows.
+     */
+    bool IsValid() const { return m_hasDate; }
+};
+
+#endif // COLUMNPLAN_H
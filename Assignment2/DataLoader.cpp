@@ -1,23 +1,443 @@
 #include "DataLoader.h"
+#include "MappedFile.h"
+#include "Snapshot.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string_view>
+#include <thread>
 
-DataLoader::DataLoader() : data() {}
+namespace {
+
+// Find the end of the line that starts at first
+const char* LineEnd(const char* first, const char* last) {
+    if (first == last) {
+        return last;
+    }
+    const void* found = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+    return found != nullptr ? static_cast<const char*>(found) : last;
+}
+
+// Find the offset just past the last newline of a buffer (0 if it holds no complete line)
+std::size_t CompleteLinesEnd(const char* data, std::size_t size) {
+    while (size > 0 && data[size - 1] != '\n') {
+        --size;
+    }
+    return size;
+}
+
+// The most rows a year of 10-minute readings can hold (366 days * 144 readings)
+const std::size_t MAX_ROWS_PER_YEAR = 366 * 144;
+
+// The smallest byte range worth handing to its own thread
+const std::size_t MIN_CHUNK_BYTES = 1 << 20;
+
+// Parse the complete lines in [first, last) with a compiled plan and append the rows to target
+void ParseRange(const ColumnPlan& plan, const char* first, const char* last, std::map<int, YearColumns>& target) {
+    // Estimate the number of rows from the length of the first line
+    std::size_t bytesPerRow = static_cast<std::size_t>(LineEnd(first, last) - first) + 1;
+    std::vector<int> reservedYears;
+
+    MonthData monthData;
+    while (first != last) {
+        const char* lineEnd = LineEnd(first, last);
+
+        if (plan.ParseLine(first, lineEnd, monthData)) {
+            YearColumns& yearData = target[monthData.m_year];
+            if (std::find(reservedYears.begin(), reservedYears.end(), monthData.m_year) == reservedYears.end()) {
+                // Reserve room for the rest of the range, capped at one full year of readings
+                std::size_t remainingRows = static_cast<std::size_t>(last - first) / bytesPerRow + 1;
+                yearData.Reserve(yearData.Size() + std::min(remainingRows, MAX_ROWS_PER_YEAR));
+                reservedYears.push_back(monthData.m_year);
+            }
+            yearData.Append(monthData);
+        }
+
+        first = lineEnd == last ? last : lineEnd + 1;
+    }
+}
+
+// Count the rows of every year of a map
+std::size_t CountRows(const std::map<int, YearColumns>& years) {
+    std::size_t rows = 0;
+    for (const auto& yearDataPair : years) {
+        rows += yearDataPair.second.Size();
+    }
+    return rows;
+}
+
+// The bytes at the end of what was parsed from a file that a poll checks are unchanged
+const std::size_t TAIL_BYTES = 64;
+
+// Keep the last bytes of [first, last) as the tail of what was parsed
+void KeepTail(std::string& tail, const char* first, const char* last) {
+    tail.assign(last - std::min(TAIL_BYTES, static_cast<std::size_t>(last - first)), last);
+}
+
+// Feed a line read by std::getline to the hash and tail of a file, with its newline if it had one
+void HashLine(FollowedFile& read, const std::string& line, bool newline) {
+    read.m_parsed.Update(line.data(), line.size());
+    read.m_tail += line;
+    if (newline) {
+        read.m_parsed.Update("\n", 1);
+        read.m_tail += '\n';
+    }
+    // Trim only now and then, so each line is not shifted through the tail
+    if (read.m_tail.size() > 16 * TAIL_BYTES) {
+        read.m_tail.erase(0, read.m_tail.size() - TAIL_BYTES);
+    }
+}
+
+// Check if a followed file is no longer the one its rows were parsed from: the name refers to
+// another file, the file is shorter than it was, it has the same size but a new modification
+// time, or the last bytes parsed from it have changed
+bool IsReplaced(const FollowedFile& followed, const MappedFile& file) {
+    const FileInfo& before = followed.m_file;
+    const FileInfo& now = file.Info();
+    std::uint64_t parsed = followed.m_parsed.Size();
+    if (now.m_volume != before.m_volume || now.m_index != before.m_index || now.m_size < before.m_size
+        || now.m_size < parsed || (now.m_size == before.m_size && now.m_modified != before.m_modified)) {
+        return true;
+    }
+    const std::string& tail = followed.m_tail;
+    return !tail.empty() && std::memcmp(file.Data() + parsed - tail.size(), tail.data(), tail.size()) != 0;
+}
+
+// Append the rows of partial to target year by year, leaving partial empty
+void AppendYears(std::map<int, YearColumns>& target, std::map<int, YearColumns>& partial) {
+    for (auto& yearDataPair : partial) {
+        target[yearDataPair.first].Append(yearDataPair.second);
+    }
+    partial.clear();
+}
+
+} // namespace
+
+DataLoader::DataLoader() : data(), loadMode(LoadMode::Mapped), sensorColumns(SENSOR_ALL), threadCount(0), snapshotPath(), follow(false), followedFiles(), sourceStamps(),
+      duplicatePolicy(DuplicatePolicy::KeepFirst), duplicatesRemoved(0), compactStorage(false),
+      yearRevisions(), revision(0) {}
+
+void DataLoader::SetLoadMode(LoadMode mode) {
+    loadMode = mode;
+}
+
+LoadMode DataLoader::GetLoadMode() const {
+    return loadMode;
+}
+
+void DataLoader::SetSensorColumns(unsigned columns) {
+    sensorColumns = columns;
+}
+
+unsigned DataLoader::GetSensorColumns() const {
+    return sensorColumns;
+}
+
+void DataLoader::SetThreadCount(unsigned threads) {
+    threadCount = threads;
+}
+
+unsigned DataLoader::GetThreadCount() const {
+    return threadCount;
+}
+
+void DataLoader::SetSnapshotPath(const std::string& path) {
+    snapshotPath = path;
+}
+
+const std::string& DataLoader::GetSnapshotPath() const {
+    return snapshotPath;
+}
+
+void DataLoader::SetDuplicatePolicy(DuplicatePolicy policy) {
+    duplicatePolicy = policy;
+}
+
+DuplicatePolicy DataLoader::GetDuplicatePolicy() const {
+    return duplicatePolicy;
+}
+
+std::size_t DataLoader::GetDuplicatesRemoved() const {
+    return duplicatesRemoved;
+}
+
+std::uint64_t DataLoader::GetRevision(int year) const {
+    auto found = yearRevisions.find(year);
+    return found == yearRevisions.end() ? 0 : found->second;
+}
+
+std::uint64_t DataLoader::GetRevision() const {
+    return revision;
+}
+
+void DataLoader::SetCompactStorage(bool enabled) {
+    compactStorage = enabled;
+    for (auto& yearDataPair : data) {
+        if (compactStorage) {
+            yearDataPair.second.Compact();
+        } else {
+            yearDataPair.second.Expand();
+        }
+    }
+}
+
+bool DataLoader::GetCompactStorage() const {
+    return compactStorage;
+}
+
+std::size_t DataLoader::GetStorageBytes() const {
+    std::size_t bytes = 0;
+    for (const auto& yearDataPair : data) {
+        bytes += yearDataPair.second.Bytes();
+    }
+    return bytes;
+}
+
+void DataLoader::SetFollow(bool enabled) {
+    follow = enabled;
+}
+
+bool DataLoader::GetFollow() const {
+    return follow;
+}
+
+bool DataLoader::SaveSnapshot(const std::string& path, const std::vector<std::string>& sources) const {
+    std::vector<SourceStamp> stamps;
+    for (const std::string& source : sources) {
+        auto found = std::find_if(sourceStamps.begin(), sourceStamps.end(), [&](const SourceStamp& stamp) { return stamp.m_path == source; });
+        if (found == sourceStamps.end()) {
+            return false;
+        }
+        stamps.push_back(*found);
+    }
+    return Snapshot::Write(path, stamps, sensorColumns, duplicatePolicy, data);
+}
+
+void DataLoader::RecordStamp(const FollowedFile& read) {
+    SourceStamp stamp{read.m_path, read.m_parsed.Size(), read.m_file.m_modified, read.m_parsed.Value()};
+    for (SourceStamp& recorded : sourceStamps) {
+        if (recorded.m_path == read.m_path) {
+            recorded = stamp;
+            return;
+        }
+    }
+    sourceStamps.push_back(stamp);
+}
 
 // Load data from the specified file
-// In the DataLoader.cpp file
 bool DataLoader::LoadData(const std::string& filename) {
+    unsigned chunkThreads = threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threadCount;
+    std::map<int, YearColumns> partial;
+    FollowedFile read{};
+    if (!ReadFile(filename, partial, std::cout, chunkThreads, read)) {
+        return false;
+    }
+    std::size_t removed = MergeData(partial);
+    if (removed > 0) {
+        std::cout << "Removed " << removed << " duplicate readings\n";
+    }
+    RecordStamp(read);
+    if (follow) {
+        followedFiles.push_back(read);
+    }
+    return true;
+}
+
+// Load every listed file, one file per worker thread, then merge the results in list order
+bool DataLoader::LoadFiles(const std::vector<std::string>& filenames, unsigned threads) {
+    // A snapshot only describes these files on their own, so it is skipped when data is already loaded
+    bool useSnapshot = !snapshotPath.empty() && data.empty();
+    if (useSnapshot) {
+        std::map<int, YearColumns> snapshot;
+        std::vector<SourceStamp> stamps;
+        bool accepted = Snapshot::Read(snapshotPath, filenames, sensorColumns, duplicatePolicy, snapshot, stamps);
+        // Follow each file from where the bytes the snapshot was parsed from end, which must be a line end
+        std::vector<FollowedFile> followed;
+        for (std::size_t i = 0; accepted && follow && i < stamps.size(); ++i) {
+            MappedFile file;
+            FollowedFile next{};
+            next.m_path = stamps[i].m_path;
+            if (file.Open(stamps[i].m_path) && file.Size() >= stamps[i].m_size
+                && CompleteLinesEnd(file.Data(), static_cast<std::size_t>(stamps[i].m_size)) == stamps[i].m_size) {
+                const char* parsedEnd = file.Data() + stamps[i].m_size;
+                next.m_parsed.Update(file.Data(), static_cast<std::size_t>(stamps[i].m_size));
+                next.m_file = file.Info();
+                KeepTail(next.m_tail, file.Data(), parsedEnd);
+            }
+            accepted = next.m_parsed.Size() == stamps[i].m_size && next.m_parsed.Value() == stamps[i].m_hash;
+            followed.push_back(next);
+        }
+        if (accepted) {
+            std::cout << "Load snapshot: " << snapshotPath << "\n";
+            MergeData(snapshot);
+            for (const SourceStamp& stamp : stamps) {
+                sourceStamps.push_back(stamp);
+            }
+            followedFiles.insert(followedFiles.end(), followed.begin(), followed.end());
+            return true;
+        }
+    }
+
+    unsigned totalThreads = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+    unsigned fileThreads = static_cast<unsigned>(std::min<std::size_t>(totalThreads, filenames.size()));
+    // Threads left over when there are fewer files than threads split the files into chunks
+    unsigned chunkThreads = fileThreads == 0 ? 1 : std::max(1u, totalThreads / fileThreads);
+
+    std::vector<std::map<int, YearColumns>> partials(filenames.size());
+    std::vector<std::ostringstream> logs(filenames.size());
+    std::vector<char> results(filenames.size(), 0);
+    std::vector<FollowedFile> reads(filenames.size());
+    std::atomic<std::size_t> nextFile(0);
+
+    auto worker = [&]() {
+        for (std::size_t i = nextFile++; i < filenames.size(); i = nextFile++) {
+            results[i] = ReadFile(filenames[i], partials[i], logs[i], chunkThreads, reads[i]) ? 1 : 0;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < fileThreads; ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    // Merging in list order keeps the per-year row order independent of the thread count
+    for (std::size_t i = 0; i < filenames.size(); ++i) {
+        std::cout << "Load file: " << filenames[i] << "\n" << logs[i].str();
+        if (!results[i]) {
+            return false;
+        }
+        std::size_t removed = MergeData(partials[i]);
+        if (removed > 0) {
+            std::cout << "Removed " << removed << " duplicate readings\n";
+        }
+        RecordStamp(reads[i]);
+        if (follow) {
+            followedFiles.push_back(reads[i]);
+        }
+    }
+
+    if (useSnapshot) {
+        if (SaveSnapshot(snapshotPath, filenames)) {
+            std::cout << "Saved snapshot: " << snapshotPath << "\n";
+        } else {
+            std::cout << "Error writing snapshot: " << snapshotPath << "\n";
+        }
+    }
+    return true;
+}
+
+// Parse the complete lines appended to each followed file since it was last read
+std::size_t DataLoader::PollFollowedFiles() {
+    std::map<int, YearColumns> partial;
+    for (auto followed = followedFiles.begin(); followed != followedFiles.end();) {
+        MappedFile file;
+        if (!file.Open(followed->m_path)) {
+            ++followed;
+            continue;
+        }
+
+        // The rows already loaded from a replaced file cannot be told apart from the rows of
+        // other files, so they are kept and the file is not read on top of them again
+        if (IsReplaced(*followed, file)) {
+            std::cout << "File replaced, no longer following: " << followed->m_path << "\n";
+            followed = followedFiles.erase(followed);
+            continue;
+        }
+        followed->m_file = file.Info();
+
+        const char* fileStart = file.Data();
+        const char* fileEnd = fileStart + CompleteLinesEnd(fileStart, file.Size());
+        const char* parsedEnd = fileStart + followed->m_parsed.Size();
+        if (parsedEnd < fileEnd) {
+            const char* headerEnd = LineEnd(fileStart, fileEnd);
+            ColumnPlan plan = ColumnPlan::Compile(std::string_view(fileStart, static_cast<std::size_t>(headerEnd - fileStart)), sensorColumns);
+            const char* first = parsedEnd == fileStart ? headerEnd + 1 : parsedEnd;
+            if (plan.IsValid() && first < fileEnd) {
+                ParseRange(plan, first, fileEnd, partial);
+            }
+            followed->m_parsed.Update(parsedEnd, static_cast<std::size_t>(fileEnd - parsedEnd));
+            KeepTail(followed->m_tail, fileStart, fileEnd);
+            RecordStamp(*followed);
+        }
+        ++followed;
+    }
+
+    std::size_t rows = CountRows(partial);
+    return rows - MergeData(partial);
+}
+
+// Append the rows of a partial map to the stored data
+std::size_t DataLoader::MergeData(std::map<int, YearColumns>& partial) {
+    std::size_t removed = 0;
+    bool unique = duplicatePolicy != DuplicatePolicy::KeepAll;
+    for (auto& yearDataPair : partial) {
+        YearColumns& yearData = this->data[yearDataPair.first];
+        YearColumns& incoming = yearDataPair.second;
+
+        // Repeats within the new rows sit next to each other once they are sorted (only checked if already sorted)
+        if (unique) {
+            incoming.SortByTime();
+            removed += incoming.RemoveDuplicates(duplicatePolicy);
+        }
+        // Rows that continue the year in time order cannot repeat an older timestamp and only update what they touch
+        if (!yearData.Extend(incoming, unique)) {
+            // Otherwise keep the year in time order, resolve repeats of older rows,
+            // then rebuild its month index and monthly statistics
+            yearData.Append(incoming);
+            yearData.SortByTime();
+            removed += yearData.RemoveDuplicates(duplicatePolicy);
+            yearData.BuildMonthIndex();
+            yearData.BuildAggregates();
+        }
+        // New rows arrive as doubles, or as doubles again if one did not fit the scale of a compact column
+        if (compactStorage) {
+            yearData.Compact();
+        }
+        ++yearRevisions[yearDataPair.first];
+        ++revision;
+    }
+    partial.clear();
+    duplicatesRemoved += removed;
+    return removed;
+}
+
+// Read one file into the target map with the current load mode
+bool DataLoader::ReadFile(const std::string& filename, std::map<int, YearColumns>& target, std::ostream& log, unsigned chunkThreads,
+                          FollowedFile& read) const {
+    read.m_path = filename;
+    if (loadMode == LoadMode::Stream) {
+        return LoadDataStream(filename, target, log, read);
+    }
+    return LoadDataMapped(filename, target, log, chunkThreads, read);
+}
+
+// Load data from the specified file with std::getline and string streams
+bool DataLoader::LoadDataStream(const std::string& filename, std::map<int, YearColumns>& target, std::ostream& log,
+                                FollowedFile& read) const {
     //std::cout << "Loading data from file: " << filename << std::endl;
 
+    // Take the file as it is before reading, so a file written to meanwhile never matches its stamp
+    MappedFile::Stat(filename, read.m_file);
+
     std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cout << "Error opening file: " << filename << std::endl;
+        log << "Error opening file: " << filename << std::endl;
         return false;
     }
 
+    // Hash the lines read, so that a poll in follow mode starts just past them
     std::string line;
     std::getline(file, line);
+    if (!follow || !file.eof()) {
+        HashLine(read, line, !file.eof());
+    }
 
-    std::cout << "The header line is: " << line << std::endl;
+    log << "The header line is: " << line << std::endl;
 
     std::istringstream headerStream(line);
     std::string columnName;
@@ -27,10 +447,15 @@ bool DataLoader::LoadData(const std::string& filename) {
     }
 
     while (std::getline(file, line)) {
+        // In follow mode a last line without a newline may still be being written, so leave it for the next poll
+        if (follow && file.eof()) {
+            break;
+        }
+        HashLine(read, line, !file.eof());
         std::istringstream iss(line);
         std::string dataValue; // Rename the local variable
         int index = 0;
-        MonthData monthData;
+        MonthData monthData{};
 
         while (std::getline(iss, dataValue, ',')) {
             if (index >= columnNames.size()) {
@@ -40,10 +465,12 @@ bool DataLoader::LoadData(const std::string& filename) {
 
             if (columnNames[index] == "WAST") {
                 std::istringstream dateIss(dataValue);
-                std::string day, month, year;
+                std::string day, month, year, hour, minute;
                 std::getline(dateIss, day, '/');
                 std::getline(dateIss, month, '/');
                 std::getline(dateIss, year, ' ');
+                std::getline(dateIss, hour, ':');
+                std::getline(dateIss, minute);
 
                 try {
                     monthData.m_day = std::stoi(day);
@@ -54,7 +481,19 @@ bool DataLoader::LoadData(const std::string& filename) {
                     monthData.m_month = 0;
                     monthData.m_year = 0;
                 }
-            } else if (columnNames[index] == "S") {
+
+                // a missing or unreadable time is read as midnight
+                try {
+                    monthData.m_hour = std::stoi(hour);
+                    monthData.m_minute = std::stoi(minute);
+                } catch (const std::invalid_argument&) {
+                    monthData.m_hour = -1;
+                }
+                if (monthData.m_hour < 0 || monthData.m_hour > 23 || monthData.m_minute < 0 || monthData.m_minute > 59) {
+                    monthData.m_hour = 0;
+                    monthData.m_minute = 0;
+                }
+            } else if (columnNames[index] == "S" && (sensorColumns & SENSOR_WIND_SPEED)) {
                 try {
                     if (!dataValue.empty()) {
                         monthData.m_windSpeed = std::stod(dataValue);
@@ -64,7 +503,7 @@ bool DataLoader::LoadData(const std::string& filename) {
                 } catch (const std::invalid_argument&) {
                     monthData.m_windSpeed = 0.0;
                 }
-            } else if (columnNames[index] == "T") {
+            } else if (columnNames[index] == "T" && (sensorColumns & SENSOR_TEMPERATURE)) {
                 try {
                     if (!dataValue.empty()) {
                         monthData.m_temperature = std::stod(dataValue);
@@ -74,7 +513,7 @@ bool DataLoader::LoadData(const std::string& filename) {
                 } catch (const std::invalid_argument&) {
                     monthData.m_temperature = 0.0;
                 }
-            } else if (columnNames[index] == "SR") {
+            } else if (columnNames[index] == "SR" && (sensorColumns & SENSOR_SOLAR_RADIATION)) {
                 try {
                     if (!dataValue.empty()) {
                         monthData.m_solarRadiation = std::stod(dataValue);
@@ -88,14 +527,78 @@ bool DataLoader::LoadData(const std::string& filename) {
 
             index++;
         }
-        if (index >= columnNames.size() && monthData.m_year != 0 && monthData.m_month != 0) {
+        if (index >= columnNames.size() && IsValidDate(monthData.m_year, monthData.m_month, monthData.m_day)) {
             int year = monthData.m_year;
-            this->data[year].push_back(monthData);
+            target[year].Append(monthData);
 
         }
     }
 
+    if (read.m_tail.size() > TAIL_BYTES) {
+        read.m_tail.erase(0, read.m_tail.size() - TAIL_BYTES);
+    }
     file.close();
     return true;
 }
 
+// Load data from the specified file by mapping it and parsing the fields in place.
+// The header is compiled into a ColumnPlan once, so each line only converts the
+// selected columns and stops after the last of them. A large file is split into
+// newline-aligned chunks that are parsed in parallel and stitched back in file order.
+bool DataLoader::LoadDataMapped(const std::string& filename, std::map<int, YearColumns>& target, std::ostream& log, unsigned chunkThreads,
+                                FollowedFile& read) const {
+    MappedFile file;
+    if (!file.Open(filename)) {
+        log << "Error opening file: " << filename << std::endl;
+        return false;
+    }
+
+    const char* cursor = file.Data();
+    // In follow mode a last line without a newline may still be being written, so leave it for the next poll
+    const char* fileEnd = cursor + (follow ? CompleteLinesEnd(cursor, file.Size()) : file.Size());
+    read.m_parsed.Update(cursor, static_cast<std::size_t>(fileEnd - cursor));
+    read.m_file = file.Info();
+    KeepTail(read.m_tail, cursor, fileEnd);
+
+    const char* headerEnd = LineEnd(cursor, fileEnd);
+    std::string_view header(cursor, static_cast<std::size_t>(headerEnd - cursor));
+    cursor = headerEnd == fileEnd ? fileEnd : headerEnd + 1;
+
+    log << "The header line is: " << header << std::endl;
+
+    ColumnPlan plan = ColumnPlan::Compile(header, sensorColumns);
+    if (!plan.IsValid()) {
+        return true;
+    }
+
+    // Split a large file into newline-aligned byte ranges, one per worker
+    std::size_t chunkCount = std::min<std::size_t>(chunkThreads, static_cast<std::size_t>(fileEnd - cursor) / MIN_CHUNK_BYTES);
+    if (chunkCount <= 1) {
+        ParseRange(plan, cursor, fileEnd, target);
+        return true;
+    }
+
+    std::vector<const char*> bounds(chunkCount + 1, fileEnd);
+    bounds[0] = cursor;
+    for (std::size_t k = 1; k < chunkCount; ++k) {
+        const char* split = std::max(bounds[k - 1], cursor + (fileEnd - cursor) / chunkCount * k);
+        const char* lineEnd = LineEnd(split, fileEnd);
+        bounds[k] = lineEnd == fileEnd ? fileEnd : lineEnd + 1;
+    }
+
+    std::vector<std::map<int, YearColumns>> partials(chunkCount);
+    std::vector<std::thread> threads;
+    for (std::size_t k = 1; k < chunkCount; ++k) {
+        threads.emplace_back(ParseRange, std::cref(plan), bounds[k], bounds[k + 1], std::ref(partials[k]));
+    }
+    ParseRange(plan, bounds[0], bounds[1], partials[0]);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Stitch the chunks back together in file order
+    for (std::map<int, YearColumns>& partial : partials) {
+        AppendYears(target, partial);
+    }
+    return true;
+}
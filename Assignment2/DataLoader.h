@@ -1,22 +1,30 @@
 #ifndef DATALOADER_H
 #define DATALOADER_H
 
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <vector>
 #include <map>
+#include <string>
+#include "ColumnPlan.h"
+#include "MappedFile.h"
+#include "Snapshot.h"
+#include "YearColumns.h"
 
 /**
  * @brief A struct that represents a single record of weather data for a given day, month, and year.
  *
- * The struct contains fields for the day, month, and year as integers, and the wind speed, temperature, and solar radiation as doubles.
+ * The struct contains fields for the day, month, year, hour and minute as integers, and the wind speed, temperature, and solar radiation as doubles.
  * using Struct instead of a class because its easier as there is no complecated methods
  */
 struct MonthData {
     int m_day; // The day of the record as an integer (1-31)
     int m_month; // The month of the record as an integer (1-12)
     int m_year; // The year of the record as an integer
+    int m_hour; // The hour of the record (0-23)
+    int m_minute; // The minute of the record (0-59)
     double m_windSpeed; // The wind speed of the record in km/h as a double
     double m_temperature; // The temperature of the record in C as a double
     double m_solarRadiation; // The solar radiation of the record in MJ/m2 as a double
@@ -27,15 +35,114 @@ struct MonthData {
     double getSolarRadiation() const { return m_solarRadiation; }
 };
 
+/**
+ * @brief The ways DataLoader can read a CSV file.
+ *
+ * Stream reads the file line by line through std::getline and string streams.
+ * Mapped maps the whole file into memory and parses the fields in place through a
+ * ColumnPlan compiled from the header, which avoids a heap allocation per line and per field.
+ */
+enum class LoadMode {
+    Stream,
+    Mapped
+};
+
+/**
+ * @brief What was read of a file, kept in follow mode to read the lines appended to it.
+ */
+struct FollowedFile {
+    std::string m_path; // The name of the file
+    SourceHasher m_parsed; // The bytes parsed so far, up to just past the last complete line in follow mode
+    FileInfo m_file; // The file as it was when it was last read
+    std::string m_tail; // The last bytes parsed, which a poll checks are unchanged
+};
 
 /**
  * @brief A class that represents a data loader that reads weather data from files and stores them in a map structure.
  *
- * The class contains a protected map field that has keys as years and values as vectors of MonthData objects. It also provides a public method to load data from a file and insert it into the map.
+ * The class contains a protected map field that has keys as years and values as YearColumns, which store the readings of the year as sorted columns. It also provides a public method to load data from a file and insert it into the map.
  */
 class DataLoader {
 protected:
-    std::map<int, std::vector<MonthData>> data; // A map that contains weather data for different years
+    std::map<int, YearColumns> data; // A map that contains the weather data of each year in time order
+    LoadMode loadMode; // The way LoadData reads files
+    unsigned sensorColumns; // The SensorColumn flags of the sensors that LoadData converts
+    unsigned threadCount; // The number of threads LoadData may use for one file (0 means one per hardware thread)
+    std::string snapshotPath; // The snapshot LoadFiles reads and writes (empty means no snapshot)
+    bool follow; // True if loaded files are remembered so that appended lines can be read later
+    std::vector<FollowedFile> followedFiles; // The files PollFollowedFiles reads, in load order
+    std::vector<SourceStamp> sourceStamps; // The stamps of the loaded files, taken from the bytes that were parsed
+    DuplicatePolicy duplicatePolicy; // Which reading to keep when several share a timestamp
+    std::size_t duplicatesRemoved; // The number of duplicate readings removed so far
+    bool compactStorage; // True if the metric columns are stored as fixed-point integers
+    std::map<int, std::uint64_t> yearRevisions; // The number of merges that changed each year
+    std::uint64_t revision; // The number of merges that changed any year
+
+    /**
+     * @brief Read one file into a map with the current load mode.
+     *
+     * @param filename The name of the file that contains weather data.
+     * @param target The map that receives the rows of the file.
+     * @param log The stream that receives the header line and any error message.
+     * @param chunkThreads The number of threads that may parse chunks of a large file.
+     * @param read Receives the name of the file, the bytes that were parsed and the file they were read from.
+     * @return true If the file is successfully opened and read.
+     */
+    bool ReadFile(const std::string& filename, std::map<int, YearColumns>& target, std::ostream& log, unsigned chunkThreads,
+                  FollowedFile& read) const;
+
+    /**
+     * @brief Load data by reading the file line by line with string streams.
+     *
+     * @param filename The name of the file that contains weather data.
+     * @param target The map that receives the rows of the file.
+     * @param log The stream that receives the header line and any error message.
+     * @param read Receives the lines that were parsed, and the file as it was before it was read.
+     *        In follow mode a last line without a newline is left for PollFollowedFiles.
+     * @return true If the file is successfully opened and read.
+     */
+    bool LoadDataStream(const std::string& filename, std::map<int, YearColumns>& target, std::ostream& log,
+                        FollowedFile& read) const;
+
+    /**
+     * @brief Load data by mapping the file into memory and parsing the fields in place.
+     *
+     * A file larger than a few megabytes is split into byte ranges that end on line
+     * boundaries. Each range is parsed on its own thread with the plan compiled from the
+     * header, and the rows are appended to the target in file order. In follow mode a last
+     * line without a newline is left for PollFollowedFiles, as it may still be being written.
+     *
+     * @param filename The name of the file that contains weather data.
+     * @param target The map that receives the rows of the file.
+     * @param log The stream that receives the header line and any error message.
+     * @param chunkThreads The number of threads that may parse chunks of the file.
+     * @param read Receives the bytes of the mapping up to just past the last line that was parsed,
+     *        and the file that was mapped.
+     * @return true If the file is successfully opened and read.
+     */
+    bool LoadDataMapped(const std::string& filename, std::map<int, YearColumns>& target, std::ostream& log, unsigned chunkThreads,
+                        FollowedFile& read) const;
+
+    /**
+     * @brief Remember the stamp of a file from the bytes that were parsed, replacing an older stamp of it.
+     * @param read The file and the bytes of it that were parsed.
+     */
+    void RecordStamp(const FollowedFile& read);
+
+    /**
+     * @brief Append the rows of a partially loaded map to the data, year by year.
+     *
+     * Rows that continue a year in time order, such as lines appended to a followed file,
+     * are added to the month index and monthly statistics incrementally. Otherwise the year
+     * is sorted by time, with rows of the same timestamp kept in load order, and its month
+     * index and monthly statistics are rebuilt. Readings that repeat a timestamp are then
+     * resolved with the duplicate policy. In compact storage each year is compacted last.
+     * The revision of each year merged and the overall revision are then advanced.
+     *
+     * @param partial The map to be merged. It is left empty.
+     * @return std::size_t The number of duplicate readings removed.
+     */
+    std::size_t MergeData(std::map<int, YearColumns>& partial);
 
 public:
     /**
@@ -51,6 +158,176 @@ public:
      * @return false If the file cannot be opened or read.
      */
     bool LoadData(const std::string& filename);
+
+    /**
+     * @brief Load several files in parallel and insert them into the map.
+     *
+     * Each file is parsed on a worker thread into its own map. The maps are then merged in
+     * list order, so the data and the row order of each year do not depend on the thread
+     * count. The header line of each file is printed in list order as well. Loading stops
+     * at the first file that cannot be read, keeping the files listed before it. The number
+     * of duplicate readings removed is printed after each file that had any.
+     *
+     * When there are more threads than files, the spare threads split large files into
+     * chunks as LoadData does.
+     *
+     * If a snapshot path is set and nothing is loaded yet, a snapshot that is still valid
+     * for the files is read instead of parsing them. Otherwise the files are parsed and a
+     * new snapshot is written for the next run.
+     *
+     * @param filenames The names of the files that contain weather data.
+     * @param threads The number of threads to use, or 0 for one per hardware thread.
+     * @return true If every file is successfully opened and read.
+     * @return false If a file cannot be opened or read.
+     */
+    bool LoadFiles(const std::vector<std::string>& filenames, unsigned threads = 0);
+
+    /**
+     * @brief Write the loaded data to a binary snapshot (see Snapshot).
+     *
+     * Each source is stamped with the bytes that were parsed from it, not with the file as
+     * it is now, so lines appended since then make the snapshot stale rather than wrong.
+     *
+     * @param path The name of the snapshot file.
+     * @param sources The files the data was loaded from, in load order.
+     * @return true If every source was loaded and the snapshot is successfully written.
+     */
+    bool SaveSnapshot(const std::string& path, const std::vector<std::string>& sources) const;
+
+    /**
+     * @brief Set the snapshot LoadFiles reads from and writes to.
+     * @param path The name of the snapshot file, or an empty string for none (the default).
+     */
+    void SetSnapshotPath(const std::string& path);
+
+    /**
+     * @brief Get the snapshot LoadFiles reads from and writes to.
+     * @return const std::string& The name of the snapshot file, empty if there is none.
+     */
+    const std::string& GetSnapshotPath() const;
+
+    /**
+     * @brief Choose whether later loads remember their files so appended lines can be read.
+     * @param enabled True to follow the files loaded from now on. The default is false.
+     */
+    void SetFollow(bool enabled);
+
+    /**
+     * @brief Check if loaded files are followed.
+     * @return true If follow mode is on.
+     */
+    bool GetFollow() const;
+
+    /**
+     * @brief Read the complete lines appended to every followed file since the last read.
+     *
+     * Only the new bytes of each file are parsed. A file that was replaced, truncated or
+     * rewritten is no longer followed and its rows already loaded are kept, since they cannot
+     * be told apart from the rows of other files. It is replaced if the name now refers to
+     * another file, truncated if it is shorter than it was, and rewritten if it has the same
+     * size but a new modification time or the last bytes parsed from it have changed.
+     *
+     * @return std::size_t The number of readings added, not counting duplicates that were removed.
+     */
+    std::size_t PollFollowedFiles();
+
+    /**
+     * @brief Choose which reading later loads keep when several share a timestamp.
+     * @param policy The duplicate policy. The default is DuplicatePolicy::KeepFirst.
+     */
+    void SetDuplicatePolicy(DuplicatePolicy policy);
+
+    /**
+     * @brief Get the duplicate policy.
+     * @return DuplicatePolicy Which reading is kept when several share a timestamp.
+     */
+    DuplicatePolicy GetDuplicatePolicy() const;
+
+    /**
+     * @brief Get the number of duplicate readings removed by every load so far.
+     * @return std::size_t The number of readings dropped.
+     */
+    std::size_t GetDuplicatesRemoved() const;
+
+    /**
+     * @brief Get a counter that changes whenever readings of a year are loaded.
+     *
+     * Results derived from a year stay valid for as long as its revision is the same.
+     *
+     * @param year The year.
+     * @return std::uint64_t The revision of the year, or 0 if it has never been loaded.
+     */
+    std::uint64_t GetRevision(int year) const;
+
+    /**
+     * @brief Get a counter that changes whenever readings of any year are loaded.
+     * @return std::uint64_t The revision of the whole data.
+     */
+    std::uint64_t GetRevision() const;
+
+    /**
+     * @brief Choose whether the readings are stored compactly.
+     *
+     * In compact storage each metric column of a year is held as 16-bit or 32-bit fixed-point
+     * integers at the smallest decimal scale that keeps every value exact (see MetricColumn),
+     * and widened to double when read, so every result is the same as with double storage.
+     * The setting applies to the data already loaded and to later loads.
+     *
+     * @param enabled True to store readings compactly. The default is false.
+     */
+    void SetCompactStorage(bool enabled);
+
+    /**
+     * @brief Check if the readings are stored compactly.
+     * @return true If compact storage is on.
+     */
+    bool GetCompactStorage() const;
+
+    /**
+     * @brief Get the memory allocated for the readings of every year.
+     * @return std::size_t The bytes held by the timestamp and metric columns.
+     */
+    std::size_t GetStorageBytes() const;
+
+    /**
+     * @brief Choose how LoadData reads files. The default is LoadMode::Mapped.
+     * @param mode The load mode to be used by later calls to LoadData.
+     */
+    void SetLoadMode(LoadMode mode);
+
+    /**
+     * @brief Get the current load mode.
+     * @return LoadMode The way LoadData reads files.
+     */
+    LoadMode GetLoadMode() const;
+
+    /**
+     * @brief Choose which sensor columns later calls to LoadData convert.
+     *
+     * The WAST date is always loaded. Columns that are not selected are skipped without
+     * being converted and read as 0.0. The default is SENSOR_ALL.
+     *
+     * @param columns A combination of SensorColumn flags.
+     */
+    void SetSensorColumns(unsigned columns);
+
+    /**
+     * @brief Get the sensor columns that LoadData converts.
+     * @return unsigned A combination of SensorColumn flags.
+     */
+    unsigned GetSensorColumns() const;
+
+    /**
+     * @brief Set how many threads LoadData may use to parse one large file in chunks.
+     * @param threads The thread count, or 0 for one per hardware thread (the default).
+     */
+    void SetThreadCount(unsigned threads);
+
+    /**
+     * @brief Get the number of threads LoadData may use for one file.
+     * @return unsigned The thread count, or 0 for one per hardware thread.
+     */
+    unsigned GetThreadCount() const;
 };
 
 
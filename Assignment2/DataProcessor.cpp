@@ -1,4 +1,7 @@
 #include "DataProcessor.h"
+#include "OutputBuffer.h"
+
+#include <algorithm>
 
 
 DataProcessor::DataProcessor() : DataLoader() {}
@@ -21,46 +24,92 @@ std::string DataProcessor::GetMonthName(int month) { // Define the function
     }
 }
 // Search data for a specified month and year
-std::vector<MonthData> DataProcessor::Search(int month, int year) const {
-    if (data.find(year) != data.end()) {
-        std::vector<MonthData> monthDataList;
-        for (const auto& dataEntry : data.at(year)) {
-            if (dataEntry.m_month == month) {
-                monthDataList.push_back(dataEntry);
-            }
-        }
-        return monthDataList;
+ReadingsView DataProcessor::Search(int month, int year) const {
+    auto it = data.find(year);
+    if (it == data.end()) {
+        return ReadingsView();
     }
+    return it->second.Month(month);
+}
 
+ReadingsView DataProcessor::SearchDay(int day, int month, int year) const {
+    if (!IsValidDate(year, month, day)) {
+        return ReadingsView();
+    }
+    Timestamp start = MakeTimestamp(year, month, day);
+    return SearchPeriod(start, start + MINUTES_PER_DAY);
 }
 
-// Calculate average
-double DataProcessor::CalculateAverage(const std::vector<double>& values) const {
-    double sum = 0.0;
-    for (const auto& value : values) {
-        sum += value;
+// A year holds its own rows only, so the period is cut at the end of the year of from
+ReadingsView DataProcessor::SearchPeriod(Timestamp from, Timestamp to) const {
+    int year, month, day;
+    SplitTimestamp(from, year, month, day);
+    auto it = data.find(year);
+    if (it == data.end()) {
+        return ReadingsView();
     }
-    return sum / values.size();
+    return it->second.Period(from, to);
 }
 
-// Calculate total
-double DataProcessor::CalculateTotal(const std::vector<double>& values) const {
-    double sum = 0.0;
-    for (const auto& value : values) {
-        sum += value;
+ReadingsView DataProcessor::SelectYear(int year) const {
+    auto it = data.find(year);
+    if (it == data.end()) {
+        return ReadingsView();
+    }
+    return ReadingsView(it->second, 0, it->second.Size());
+}
+
+std::vector<int> DataProcessor::GetYears() const {
+    std::vector<int> years;
+    years.reserve(data.size());
+    for (const auto& yearDataPair : data) {
+        years.push_back(yearDataPair.first);
     }
-    return sum;
+    return years;
+}
+
+bool DataProcessor::HasYear(int year) const {
+    return data.find(year) != data.end();
 }
 
-// Calculate sample standard deviation
-double DataProcessor::CalculateStandardDeviation(const std::vector<double>& values) const {
-    double mean = CalculateAverage(values);
-    double variance = 0.0;
-    for (const auto& value : values) {
-        variance += pow(value - mean, 2);
+// Look up the statistics of a month in the aggregates built at load time
+const MonthAggregate& DataProcessor::GetAggregate(int month, int year) const {
+    static const MonthAggregate empty;
+    auto it = data.find(year);
+    if (it == data.end()) {
+        return empty;
     }
-    variance /= values.size() - 1;
-    return sqrt(variance);
+    return it->second.Aggregate(month);
+}
+
+const MonthAggregate& DataProcessor::GetHourAggregate(int month, int hour, int year) const {
+    static const MonthAggregate empty;
+    auto it = data.find(year);
+    if (it == data.end()) {
+        return empty;
+    }
+    return it->second.HourAggregate(month, hour);
+}
+
+// Calculate average
+double DataProcessor::CalculateAverage(Span<const double> values) const {
+    RunningStats stats;
+    stats.Add(values);
+    return stats.Mean();
+}
+
+// Calculate total
+double DataProcessor::CalculateTotal(Span<const double> values) const {
+    RunningStats stats;
+    stats.Add(values);
+    return stats.Total();
+}
+
+// Calculate sample standard deviation in one pass
+double DataProcessor::CalculateStandardDeviation(Span<const double> values) const {
+    RunningStats stats;
+    stats.Add(values);
+    return sqrt(stats.SampleVariance());
 }
 
 // Write wind speed, temperature, and solar radiation data to a CSV file
@@ -73,46 +122,33 @@ void DataProcessor::WriteDataToFile(int year) {
         return;
     }
 
-    file << "Month,Wind Speed,Temperature,Solar Radiation\n";
+    OutputBuffer buffer(file);
+    buffer.Write("Month,Wind Speed,Temperature,Solar Radiation\n");
 
     for (int month = 1; month <= 12; month++) {
-        std::vector<MonthData> monthDataList = Search(month, year);
+        const MonthAggregate& aggregate = GetAggregate(month, year);
 
-        if (!monthDataList.empty()) {
-            std::vector<double> windSpeeds;
-            std::vector<double> temperatures;
-            std::vector<double> solarRadiations;
+        if (aggregate.Count() > 0) {
+            double averageWindSpeed = aggregate.Mean(Metric::WindSpeed);
+            double averageTemperature = aggregate.Mean(Metric::Temperature);
+            double totalSolarRadiation = aggregate.Total(Metric::SolarRadiation);
 
-            for (const auto& monthData : monthDataList) {
-                windSpeeds.push_back(monthData.m_windSpeed);
-                temperatures.push_back(monthData.m_temperature);
-                solarRadiations.push_back(monthData.m_solarRadiation);
-            }
-
-            double averageWindSpeed = CalculateAverage(windSpeeds);
-            double averageTemperature = CalculateAverage(temperatures);
-            double totalSolarRadiation = CalculateTotal(solarRadiations);
-
-            file << GetMonthName(month) << "," << averageWindSpeed << "," << averageTemperature << "," << totalSolarRadiation << "\n";
+            buffer.Write(GetMonthName(month)).Write(',').WriteGeneral(averageWindSpeed).Write(',')
+                  .WriteGeneral(averageTemperature).Write(',').WriteGeneral(totalSolarRadiation).Write('\n');
         }
 
     }
 
+    buffer.Flush();
     file.close();
 }
 // Print average wind speed and standard deviation for a specified month
 void DataProcessor::PrintAverageWindSpeed(int month, int year) {
-    std::vector<MonthData> monthDataList = Search(month, year);
-
-    if (!monthDataList.empty()) {
-        std::vector<double> windSpeeds;
-
-        for (const auto& monthData : monthDataList) {
-            windSpeeds.push_back(monthData.m_windSpeed);
-        }
+    const MonthAggregate& aggregate = GetAggregate(month, year);
 
-        double averageWindSpeed = CalculateAverage(windSpeeds);
-        double standardDeviationWindSpeed = CalculateStandardDeviation(windSpeeds);
+    if (aggregate.Count() > 0) {
+        double averageWindSpeed = aggregate.Mean(Metric::WindSpeed);
+        double standardDeviationWindSpeed = sqrt(aggregate.SampleVariance(Metric::WindSpeed));
 
         std::cout << "Average wind speed for " << GetMonthName(month) << " " << year << ": " << averageWindSpeed << " m/s\n";
         std::cout << "Standard deviation of wind speed for " << GetMonthName(month) << " " << year << ": " << standardDeviationWindSpeed << " m/s\n";
@@ -124,17 +160,11 @@ void DataProcessor::PrintAverageWindSpeed(int month, int year) {
 // Print average temperature and standard deviation for each month
 void DataProcessor::PrintAverageTemperature(int year) {
     for (int month = 1; month <= 12; month++) {
-        std::vector<MonthData> monthDataList = Search(month, year);
+        const MonthAggregate& aggregate = GetAggregate(month, year);
 
-        if (!monthDataList.empty()) {
-            std::vector<double> temperatures;
-
-            for (const auto& monthData : monthDataList) {
-                temperatures.push_back(monthData.m_temperature);
-            }
-
-            double averageTemperature = CalculateAverage(temperatures);
-            double standardDeviationTemperature = CalculateStandardDeviation(temperatures);
+        if (aggregate.Count() > 0) {
+            double averageTemperature = aggregate.Mean(Metric::Temperature);
+            double standardDeviationTemperature = sqrt(aggregate.SampleVariance(Metric::Temperature));
 
             std::cout << "Average temperature for " << GetMonthName(month) << " " << year << ": " << averageTemperature << " C\n";
             std::cout << "Standard deviation of temperature for " << GetMonthName(month) << " " << year << ": " << standardDeviationTemperature << " C\n";
@@ -147,16 +177,10 @@ void DataProcessor::PrintAverageTemperature(int year) {
 // Print solar radiation for each month
 void DataProcessor::PrintSolarRadiation(int year) {
     for (int month = 1; month <= 12; month++) {
-        std::vector<MonthData> monthDataList = Search(month, year);
-
-        if (!monthDataList.empty()) {
-            std::vector<double> solarRadiations;
-
-            for (const auto& monthData : monthDataList) {
-                solarRadiations.push_back(monthData.m_solarRadiation);
-            }
+        const MonthAggregate& aggregate = GetAggregate(month, year);
 
-            double totalSolarRadiation = CalculateTotal(solarRadiations);
+        if (aggregate.Count() > 0) {
+            double totalSolarRadiation = aggregate.Total(Metric::SolarRadiation);
 
             std::cout << "Total solar radiation for " << GetMonthName(month) << " " << year << ": " << totalSolarRadiation / 1000.0  <<" kWh/m2\n";
         } else {
@@ -166,16 +190,95 @@ void DataProcessor::PrintSolarRadiation(int year) {
 }
 
 // Display data for a given year
-void DataProcessor::DisplayDataForYear(int year) const {
-    if (data.find(year) != data.end()) {
-        std::cout<<std::setw(10)<<std::left<<"Date"<<std::setw(15)<<std::left<<"Wind Speed"<<std::setw(15)<<std::left<<"Temperature"<<std::setw(15)<<std::left<<"Solar Radiation"<<std::endl;
-        for (const auto& dataEntry : data.at(year)) {
-            std::cout<<std::setw(10)<<std::left<<dataEntry.m_day<<"/"<<dataEntry.m_month<<"/"<<dataEntry.m_year<<std::setw(15)<<std::left<<dataEntry.m_windSpeed<<std::setw(15)<<std::left<<dataEntry.m_temperature<<std::setw(15)<<std::left<<dataEntry.m_solarRadiation<<std::endl;
+// The fields are padded like std::setw with std::left; only the day is padded in the date
+void DataProcessor::DisplayDataForYear(int year, std::ostream& out) const {
+    ReadingsView yearData = SelectYear(year);
+    if (!yearData.empty()) {
+        OutputBuffer buffer(out);
+        std::size_t field = buffer.Position();
+        buffer.Write("Date").PadTo(field, 10);
+        field = buffer.Position();
+        buffer.Write("Wind Speed").PadTo(field, 15);
+        field = buffer.Position();
+        buffer.Write("Temperature").PadTo(field, 15);
+        field = buffer.Position();
+        buffer.Write("Solar Radiation").PadTo(field, 15).Write('\n');
+        for (const MonthData dataEntry : yearData) {
+            field = buffer.Position();
+            buffer.Write(static_cast<long long>(dataEntry.m_day)).PadTo(field, 10);
+            buffer.Write('/').Write(static_cast<long long>(dataEntry.m_month)).Write('/').Write(static_cast<long long>(dataEntry.m_year));
+            field = buffer.Position();
+            buffer.WriteGeneral(dataEntry.m_windSpeed).PadTo(field, 15);
+            field = buffer.Position();
+            buffer.WriteGeneral(dataEntry.m_temperature).PadTo(field, 15);
+            field = buffer.Position();
+            buffer.WriteGeneral(dataEntry.m_solarRadiation).PadTo(field, 15).Write('\n');
         }
+        buffer.Flush();
+        out.flush();
     } else {
-        std::cout<<"No data available for "<<year<<"\n";
+        out<<"No data available for "<<year<<"\n";
     }
 }
-std::map<int, std::vector<MonthData>> DataProcessor::GetData() const { // Define the function
-    return data; // Return the data member from the DataLoader class
+
+namespace {
+
+const std::size_t EXPORT_BLOCK = 1024; // The readings widened to doubles per call of the sink
+
+// Visit the months of each year that pass a filter, with the part of the month inside the period
+template <typename Visit>
+void ForEachExportMonth(const std::map<int, YearColumns>& data, const ExportFilter& filter, Visit visit) {
+    for (auto it = data.lower_bound(filter.firstYear); it != data.end() && it->first <= filter.lastYear; ++it) {
+        int firstMonth = filter.month == 0 ? 1 : filter.month;
+        int lastMonth = filter.month == 0 ? 12 : filter.month;
+        for (int month = firstMonth; month <= lastMonth; ++month) {
+            Timestamp start = MonthStart(it->first, month);
+            Timestamp end = MonthStart(it->first, month + 1);
+            visit(it->first, month, it->second, std::max(start, filter.from), std::min(end, filter.to),
+                  start >= filter.from && end <= filter.to);
+        }
+    }
+}
+
+} // namespace
+
+void DataProcessor::ExportReadings(const ExportFilter& filter, ExportSink& sink) const {
+    sink.Begin(ExportSink::Content::Readings);
+    double windSpeed[EXPORT_BLOCK];
+    double temperature[EXPORT_BLOCK];
+    double solarRadiation[EXPORT_BLOCK];
+    ForEachExportMonth(data, filter, [&](int, int, const YearColumns& columns, Timestamp from, Timestamp to, bool) {
+        ReadingsView rows = columns.Period(from, to);
+        Span<const Timestamp> timestamps = rows.Timestamps();
+        for (std::size_t first = 0; first < rows.size(); first += EXPORT_BLOCK) {
+            std::size_t count = std::min(EXPORT_BLOCK, rows.size() - first);
+            rows.WindSpeed().Read(first, count, windSpeed);
+            rows.Temperature().Read(first, count, temperature);
+            rows.SolarRadiation().Read(first, count, solarRadiation);
+            sink.WriteReadings(ReadingBlock{timestamps.data() + first, windSpeed, temperature, solarRadiation, count});
+        }
+    });
+    sink.Finish();
+}
+
+void DataProcessor::ExportAggregates(const ExportFilter& filter, ExportSink& sink) const {
+    sink.Begin(ExportSink::Content::Aggregates);
+    ForEachExportMonth(data, filter, [&](int year, int month, const YearColumns& columns, Timestamp from, Timestamp to, bool whole) {
+        if (whole) {
+            const MonthAggregate& aggregate = columns.Aggregate(month);
+            if (aggregate.Count() > 0) {
+                sink.WriteAggregate(year, month, aggregate);
+            }
+            return;
+        }
+        ReadingsView rows = columns.Period(from, to);
+        if (rows.empty()) {
+            return;
+        }
+        const ColumnSpan values[METRIC_COUNT] = {rows.WindSpeed(), rows.Temperature(), rows.SolarRadiation()};
+        MonthAggregate aggregate;
+        aggregate.Add(values);
+        sink.WriteAggregate(year, month, aggregate);
+    });
+    sink.Finish();
 }
@@ -1,6 +1,7 @@
 #ifndef DATA_PROCESSOR_H
 #define DATA_PROCESSOR_H
 #include "DataLoader.h"
+#include "ExportSink.h"
 
 #include <fstream>
 #include <sstream>
@@ -12,8 +13,8 @@
  * @brief A class that extends the DataLoader functionality to process and analyze weather data.
  *
  * The DataProcessor class inherits from the DataLoader class and provides additional methods to process, analyze, and display weather data.
- * It stores weather data in a map structure, where each year is associated with a vector of MonthData objects.
- * The class enables searching for data by month and year efficiently using the map structure.
+ * It stores weather data in a map structure, where each year is associated with the columns of its readings in time order.
+ * The class enables searching for data by month and year efficiently using the map structure and a month index of each year.
  * DataProcessor offers various statistical calculations, such as calculating average, total, and sample standard deviation of wind speed, temperature, and solar radiation.
  * It can write selected weather data to a CSV file and display weather data for a given year in a table format.
  * The DataProcessor class acts as a powerful tool for working with weather data, providing essential analysis and visualization capabilities.
@@ -32,35 +33,98 @@ public:
     /**
      * @brief Search for data by month and year.
      *
+     * The month is looked up in the month index built at load time, so the search is O(1)
+     * and nothing is copied.
+     *
      * @param month The month to be searched as an integer (1-12).
      * @param year The year to be searched as an integer.
-     * @return std::vector<MonthData> A vector of MonthData objects that match the month and year criteria.
+     * @return ReadingsView A non-owning view of the readings that match the month and year criteria, empty if there are none.
+     */
+    ReadingsView Search(int month, int year) const;
+
+    /**
+     * @brief Select all readings of a year without copying them.
+     *
+     * @param year The year to be selected as an integer.
+     * @return ReadingsView A view of the readings of that year, empty if there are none.
      */
-    std::vector<MonthData> Search(int month, int year) const;
+    ReadingsView SelectYear(int year) const;
 
     /**
-     * @brief Calculate the average of a vector of values.
+     * @brief Get the readings of one day, found with the search index of its year.
      *
-     * @param values A vector of double values.
+     * @param day The day of the month.
+     * @param month The month as an integer (1-12).
+     * @param year The year as an integer.
+     * @return ReadingsView A view of the readings of that day, empty if there are none or the date is invalid.
+     */
+    ReadingsView SearchDay(int day, int month, int year) const;
+
+    /**
+     * @brief Get the readings taken in a period within one year.
+     *
+     * @param from The start of the period.
+     * @param to The end of the period, not included. Readings after the year of from are not returned.
+     * @return ReadingsView A view of the readings with from <= timestamp < to, empty if there are none.
+     */
+    ReadingsView SearchPeriod(Timestamp from, Timestamp to) const;
+
+    /**
+     * @brief List the years that have data.
+     * @return std::vector<int> The years in ascending order.
+     */
+    std::vector<int> GetYears() const;
+
+    /**
+     * @brief Check if any data was loaded for a year, without copying the data.
+     *
+     * @param year The year to be checked as an integer.
+     * @return true If the year has data.
+     */
+    bool HasYear(int year) const;
+
+    /**
+     * @brief Get the statistics of a month, computed once when the data was loaded.
+     *
+     * @param month The month as an integer (1-12).
+     * @param year The year as an integer.
+     * @return const MonthAggregate& The count, totals, means, variances and co-moments of the month (a count of 0 if there is no data).
+     */
+    const MonthAggregate& GetAggregate(int month, int year) const;
+
+    /**
+     * @brief Get the statistics of one hour of the day over a month, computed once when the data was loaded.
+     *
+     * @param month The month as an integer (1-12).
+     * @param hour The hour of the day (0-23).
+     * @param year The year as an integer.
+     * @return const MonthAggregate& The statistics of the readings taken in that hour (a count of 0 if there is no data).
+     */
+    const MonthAggregate& GetHourAggregate(int month, int hour, int year) const;
+
+    /**
+     * @brief Calculate the average of an array of values.
+     *
+     * @param values A contiguous array of double values (a std::vector converts implicitly).
      * @return double The average of the values.
      */
-    double CalculateAverage(const std::vector<double>& values) const;
+    double CalculateAverage(Span<const double> values) const;
 
     /**
-     * @brief Calculate the total of a vector of values.
+     * @brief Calculate the total of an array of values.
      *
-     * @param values A vector of double values.
+     * @param values A contiguous array of double values.
      * @return double The total of the values.
      */
-    double CalculateTotal(const std::vector<double>& values) const;
+    double CalculateTotal(Span<const double> values) const;
 
     /**
-     * @brief Calculate the sample standard deviation of a vector of values.
+     * @brief Calculate the sample standard deviation of an array of values.
      *
-     * @param values A vector of double values.
+     * @param values A contiguous array of double values.
      * @return double The sample standard deviation of the values.
      */
-    double CalculateStandardDeviation(const std::vector<double>& values) const;
+    double CalculateStandardDeviation(Span<const double> values) const;
 
     /**
      * @brief Print the average wind speed and standard deviation for a specified month and year to the console.
@@ -90,11 +154,35 @@ public:
      */
     void WriteDataToFile(int year);
 
+    /**
+     * @brief Stream the readings that pass a filter to a sink, in time order.
+     *
+     * The readings are read straight from the columns of each year in blocks, so no copy of
+     * the selection is built whatever its size. The sink is begun and finished.
+     *
+     * @param filter The years, month and period to be exported.
+     * @param sink The sink the readings are written to.
+     */
+    void ExportReadings(const ExportFilter& filter, ExportSink& sink) const;
+
+    /**
+     * @brief Stream the statistics of each month that passes a filter to a sink, in time order.
+     *
+     * A month wholly inside the period uses the statistics computed at load time. A month cut by
+     * the period is summarised from its readings in the period. Months without readings are skipped.
+     *
+     * @param filter The years, month and period to be exported.
+     * @param sink The sink the statistics are written to.
+     */
+    void ExportAggregates(const ExportFilter& filter, ExportSink& sink) const;
+
     /**
      * @brief Display all weather data for a given year in a table format.
      * @param year The year to be displayed as an integer.
+     * @param out The stream the table is written to. The rows are written in large blocks and
+     * the stream is flushed once at the end.
      */
-    void DisplayDataForYear(int year) const;
+    void DisplayDataForYear(int year, std::ostream& out = std::cout) const;
 
     /**
      * @brief Get the month name based on its index (1-12).
@@ -102,12 +190,6 @@ public:
      * @return std::string The name of the month (e.g., January, February, etc.).
      */
     std::string GetMonthName(int month);
-
-    /**
-     * @brief Get the map that contains all weather data.
-     * @return std::map<int, std::vector<MonthData>> The map that has keys as years and values as vectors of MonthData objects.
-     */
-    std::map<int, std::vector<MonthData>> GetData() const;
 };
 
 #endif // DATA_PROCESSOR_H
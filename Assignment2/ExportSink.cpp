@@ -0,0 +1,216 @@
+#include "ExportSink.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char* const METRIC_NAMES[METRIC_COUNT] = {"windSpeed", "temperature", "solarRadiation"};
+const char* const METRIC_COLUMNS[METRIC_COUNT] = {"WindSpeed", "Temperature", "SolarRadiation"};
+
+const std::size_t READING_RECORD = 28; // The bytes of a binary reading record
+const std::size_t AGGREGATE_RECORD = 136; // The bytes of a binary aggregate record
+
+// Append a number with at least two digits, zero padded
+void WriteTwoDigits(OutputBuffer& buffer, int value) {
+    if (value < 10) {
+        buffer.Write('0');
+    }
+    buffer.Write(static_cast<long long>(value));
+}
+
+// Append a time as YYYY-MM-DDTHH:MM
+void WriteTime(OutputBuffer& buffer, Timestamp timestamp) {
+    int year, month, day;
+    SplitTimestamp(timestamp, year, month, day);
+    int minute = MinuteOfDay(timestamp);
+    for (int width = 1000; width > 1 && year < width; width /= 10) {
+        buffer.Write('0');
+    }
+    buffer.Write(static_cast<long long>(year)).Write('-');
+    WriteTwoDigits(buffer, month);
+    buffer.Write('-');
+    WriteTwoDigits(buffer, day);
+    buffer.Write('T');
+    WriteTwoDigits(buffer, minute / 60);
+    buffer.Write(':');
+    WriteTwoDigits(buffer, minute % 60);
+}
+
+// The sample standard deviation, NaN for fewer than two readings
+double SampleStdev(const MonthAggregate& aggregate, int metric) {
+    return aggregate.Count() < 2 ? std::nan("") : std::sqrt(aggregate.SampleVariance(metric));
+}
+
+// Append a number, or nothing (CSV) or null (JSON) when it is not finite
+void WriteNumber(OutputBuffer& buffer, double value, const char* missing) {
+    if (std::isfinite(value)) {
+        buffer.WriteShortest(value);
+    } else {
+        buffer.Write(missing);
+    }
+}
+
+// Store integers and doubles least significant byte first
+char* PutU32(char* out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        *out++ = static_cast<char>(value >> (8 * i));
+    }
+    return out;
+}
+
+char* PutU64(char* out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        *out++ = static_cast<char>(value >> (8 * i));
+    }
+    return out;
+}
+
+char* PutF64(char* out, double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return PutU64(out, bits);
+}
+
+} // namespace
+
+std::unique_ptr<ExportSink> ExportSink::Create(const std::string& format, std::ostream& out) {
+    if (format == "csv") {
+        return std::unique_ptr<ExportSink>(new CsvSink(out));
+    }
+    if (format == "ndjson") {
+        return std::unique_ptr<ExportSink>(new JsonLinesSink(out));
+    }
+    if (format == "binary") {
+        return std::unique_ptr<ExportSink>(new BinarySink(out));
+    }
+    return nullptr;
+}
+
+CsvSink::CsvSink(std::ostream& out) : m_buffer(out) {}
+
+void CsvSink::Begin(Content content) {
+    if (content == Content::Readings) {
+        m_buffer.Write("Time,WindSpeed,Temperature,SolarRadiation\n");
+        return;
+    }
+    m_buffer.Write("Year,Month,Count");
+    for (const char* column : METRIC_COLUMNS) {
+        for (const char* statistic : {"Mean", "Stdev", "Min", "Max", "Total"}) {
+            m_buffer.Write(',').Write(column).Write(statistic);
+        }
+    }
+    m_buffer.Write('\n');
+}
+
+void CsvSink::WriteReadings(const ReadingBlock& block) {
+    for (std::size_t i = 0; i < block.size; ++i) {
+        WriteTime(m_buffer, block.timestamps[i]);
+        m_buffer.Write(',');
+        WriteNumber(m_buffer, block.windSpeed[i], "");
+        m_buffer.Write(',');
+        WriteNumber(m_buffer, block.temperature[i], "");
+        m_buffer.Write(',');
+        WriteNumber(m_buffer, block.solarRadiation[i], "");
+        m_buffer.Write('\n');
+    }
+}
+
+void CsvSink::WriteAggregate(int year, int month, const MonthAggregate& aggregate) {
+    m_buffer.Write(static_cast<long long>(year)).Write(',').Write(static_cast<long long>(month)).Write(',')
+        .Write(static_cast<long long>(aggregate.Count()));
+    for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+        for (double value : {aggregate.Mean(metric), SampleStdev(aggregate, metric), aggregate.Min(metric),
+                             aggregate.Max(metric), aggregate.Total(metric)}) {
+            m_buffer.Write(',');
+            WriteNumber(m_buffer, value, "");
+        }
+    }
+    m_buffer.Write('\n');
+}
+
+void CsvSink::Finish() {
+    m_buffer.Flush();
+}
+
+JsonLinesSink::JsonLinesSink(std::ostream& out) : m_buffer(out) {}
+
+void JsonLinesSink::Begin(Content) {}
+
+void JsonLinesSink::WriteReadings(const ReadingBlock& block) {
+    for (std::size_t i = 0; i < block.size; ++i) {
+        m_buffer.Write("{\"time\":\"");
+        WriteTime(m_buffer, block.timestamps[i]);
+        m_buffer.Write("\",\"windSpeed\":");
+        WriteNumber(m_buffer, block.windSpeed[i], "null");
+        m_buffer.Write(",\"temperature\":");
+        WriteNumber(m_buffer, block.temperature[i], "null");
+        m_buffer.Write(",\"solarRadiation\":");
+        WriteNumber(m_buffer, block.solarRadiation[i], "null");
+        m_buffer.Write("}\n");
+    }
+}
+
+void JsonLinesSink::WriteAggregate(int year, int month, const MonthAggregate& aggregate) {
+    m_buffer.Write("{\"year\":").Write(static_cast<long long>(year))
+        .Write(",\"month\":").Write(static_cast<long long>(month))
+        .Write(",\"count\":").Write(static_cast<long long>(aggregate.Count()));
+    for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+        m_buffer.Write(",\"").Write(METRIC_NAMES[metric]).Write("\":{\"mean\":");
+        WriteNumber(m_buffer, aggregate.Mean(metric), "null");
+        m_buffer.Write(",\"stdev\":");
+        WriteNumber(m_buffer, SampleStdev(aggregate, metric), "null");
+        m_buffer.Write(",\"min\":");
+        WriteNumber(m_buffer, aggregate.Min(metric), "null");
+        m_buffer.Write(",\"max\":");
+        WriteNumber(m_buffer, aggregate.Max(metric), "null");
+        m_buffer.Write(",\"total\":");
+        WriteNumber(m_buffer, aggregate.Total(metric), "null");
+        m_buffer.Write('}');
+    }
+    m_buffer.Write("}\n");
+}
+
+void JsonLinesSink::Finish() {
+    m_buffer.Flush();
+}
+
+BinarySink::BinarySink(std::ostream& out) : m_buffer(out) {}
+
+void BinarySink::Begin(Content content) {
+    char header[16];
+    std::memcpy(header, "WXEXPORT", 8);
+    char* out = PutU32(header + 8, VERSION);
+    PutU32(out, content == Content::Readings ? 1 : 2);
+    m_buffer.Write(std::string_view(header, sizeof(header)));
+}
+
+void BinarySink::WriteReadings(const ReadingBlock& block) {
+    char record[READING_RECORD];
+    for (std::size_t i = 0; i < block.size; ++i) {
+        char* out = PutU32(record, static_cast<std::uint32_t>(block.timestamps[i]));
+        out = PutF64(out, block.windSpeed[i]);
+        out = PutF64(out, block.temperature[i]);
+        PutF64(out, block.solarRadiation[i]);
+        m_buffer.Write(std::string_view(record, sizeof(record)));
+    }
+}
+
+void BinarySink::WriteAggregate(int year, int month, const MonthAggregate& aggregate) {
+    char record[AGGREGATE_RECORD];
+    char* out = PutU32(record, static_cast<std::uint32_t>(year));
+    out = PutU32(out, static_cast<std::uint32_t>(month));
+    out = PutU64(out, aggregate.Count());
+    for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+        out = PutF64(out, aggregate.Mean(metric));
+        out = PutF64(out, SampleStdev(aggregate, metric));
+        out = PutF64(out, aggregate.Min(metric));
+        out = PutF64(out, aggregate.Max(metric));
+        out = PutF64(out, aggregate.Total(metric));
+    }
+    m_buffer.Write(std::string_view(record, sizeof(record)));
+}
+
+void BinarySink::Finish() {
+    m_buffer.Flush();
+}
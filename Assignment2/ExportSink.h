@@ -0,0 +1,154 @@
+#ifndef EXPORTSINK_H
+#define EXPORTSINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include "OutputBuffer.h"
+#include "StatsAccumulator.h"
+#include "Timestamp.h"
+
+/**
+ * @brief The readings or months an export covers. Every condition must hold.
+ */
+struct ExportFilter {
+    int firstYear = MIN_TIMESTAMP_YEAR; // The first year included
+    int lastYear = MAX_TIMESTAMP_YEAR; // The last year included
+    int month = 0; // The only month included (1-12), or 0 for every month
+    Timestamp from = std::numeric_limits<Timestamp>::min(); // The start of the period included
+    Timestamp to = std::numeric_limits<Timestamp>::max(); // The end of the period, not included
+};
+
+/**
+ * @brief A run of consecutive readings in time order, one array per column.
+ *
+ * The arrays are only valid during the call they are passed to.
+ */
+struct ReadingBlock {
+    const Timestamp* timestamps; // The times of the readings
+    const double* windSpeed; // The wind speeds in km/h
+    const double* temperature; // The temperatures in degrees C
+    const double* solarRadiation; // The solar radiation in W/m2
+    std::size_t size; // The number of readings
+};
+
+/**
+ * @brief Receives the records of an export and writes them in one format.
+ *
+ * DataProcessor::ExportReadings streams the filtered readings straight from the columns of
+ * each year in blocks, and DataProcessor::ExportAggregates passes the statistics of each month.
+ * A sink is used for one export: Begin, the records, then Finish.
+ */
+class ExportSink {
+public:
+    /**
+     * @brief The kinds of record an export can hold.
+     */
+    enum class Content { Readings, Aggregates };
+
+    virtual ~ExportSink() = default;
+
+    /**
+     * @brief Start the export, for example by writing a header.
+     * @param content The kind of record that follows.
+     */
+    virtual void Begin(Content content) = 0;
+
+    /**
+     * @brief Write a block of readings.
+     * @param block The readings.
+     */
+    virtual void WriteReadings(const ReadingBlock& block) = 0;
+
+    /**
+     * @brief Write the statistics of one month, or of the part of it inside the filter period.
+     *
+     * @param year The year.
+     * @param month The month (1-12).
+     * @param aggregate The statistics. The count is never 0.
+     */
+    virtual void WriteAggregate(int year, int month, const MonthAggregate& aggregate) = 0;
+
+    /**
+     * @brief End the export and hand everything written to the stream.
+     */
+    virtual void Finish() = 0;
+
+    /**
+     * @brief Create the sink of a format.
+     *
+     * @param format "csv", "ndjson" or "binary".
+     * @param out The stream the records are written to. It must outlive the sink.
+     * @return std::unique_ptr<ExportSink> The sink, or nullptr for an unknown format.
+     */
+    static std::unique_ptr<ExportSink> Create(const std::string& format, std::ostream& out);
+};
+
+/**
+ * @brief Writes comma separated values with a header line.
+ *
+ * Readings:   Time,WindSpeed,Temperature,SolarRadiation
+ * Aggregates: Year,Month,Count, then Mean, Stdev, Min, Max and Total of each metric
+ * Times are written as YYYY-MM-DDTHH:MM and numbers in the shortest form that reads back
+ * exactly. A standard deviation of fewer than two readings is left empty.
+ */
+class CsvSink : public ExportSink {
+public:
+    explicit CsvSink(std::ostream& out);
+    void Begin(Content content) override;
+    void WriteReadings(const ReadingBlock& block) override;
+    void WriteAggregate(int year, int month, const MonthAggregate& aggregate) override;
+    void Finish() override;
+
+private:
+    OutputBuffer m_buffer; // The buffer in front of the stream
+};
+
+/**
+ * @brief Writes one JSON object per line (newline-delimited JSON).
+ *
+ * Readings:   {"time":"2007-01-01T09:00","windSpeed":6,"temperature":22.1,"solarRadiation":15}
+ * Aggregates: {"year":2007,"month":1,"count":4464,"windSpeed":{"mean":..,"stdev":..,"min":..,"max":..,"total":..},...}
+ * A standard deviation of fewer than two readings is null.
+ */
+class JsonLinesSink : public ExportSink {
+public:
+    explicit JsonLinesSink(std::ostream& out);
+    void Begin(Content content) override;
+    void WriteReadings(const ReadingBlock& block) override;
+    void WriteAggregate(int year, int month, const MonthAggregate& aggregate) override;
+    void Finish() override;
+
+private:
+    OutputBuffer m_buffer; // The buffer in front of the stream
+};
+
+/**
+ * @brief Writes packed little-endian records, whatever the byte order of the machine.
+ *
+ * The layout has no padding:
+ *   header:    magic "WXEXPORT", u32 version (1), u32 content (1 readings, 2 aggregates)
+ *   reading:   i32 minutes since 1/01/1970 0:00, f64 wind speed, f64 temperature, f64 solar radiation (28 bytes)
+ *   aggregate: i32 year, i32 month, u64 count, then f64 mean, stdev, min, max and total
+ *              of wind speed, temperature and solar radiation (136 bytes)
+ * The records follow the header until the end of the file. A standard deviation of fewer
+ * than two readings is NaN.
+ */
+class BinarySink : public ExportSink {
+public:
+    static const std::uint32_t VERSION = 1;
+
+    explicit BinarySink(std::ostream& out);
+    void Begin(Content content) override;
+    void WriteReadings(const ReadingBlock& block) override;
+    void WriteAggregate(int year, int month, const MonthAggregate& aggregate) override;
+    void Finish() override;
+
+private:
+    OutputBuffer m_buffer; // The buffer in front of the stream
+};
+
+#endif // EXPORTSINK_H
@@ -0,0 +1,366 @@
+#include "Kernels.h"
+
+#include <atomic>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#define KERNELS_AVX2 __attribute__((target("avx2,fma")))
+#define KERNELS_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#else
+#define KERNELS_X86 0
+#endif
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+
+// The portable versions, also used for the tail of the vector loops
+template <class T>
+double ScalarSum(const T* values, std::size_t count) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+template <class T>
+double ScalarSumSquares(const T* values, std::size_t count, double shift) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        double d = values[i] - shift;
+        sum += d * d;
+    }
+    return sum;
+}
+
+template <class T>
+double ScalarSumProducts(const T* x, const T* y, std::size_t count, double shiftX, double shiftY) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        sum += (x[i] - shiftX) * (y[i] - shiftY);
+    }
+    return sum;
+}
+
+template <class T>
+double ScalarMin(const T* values, std::size_t count) {
+    double result = INF;
+    for (std::size_t i = 0; i < count; ++i) {
+        result = values[i] < result ? values[i] : result;
+    }
+    return result;
+}
+
+template <class T>
+double ScalarMax(const T* values, std::size_t count) {
+    double result = -INF;
+    for (std::size_t i = 0; i < count; ++i) {
+        result = values[i] > result ? values[i] : result;
+    }
+    return result;
+}
+
+#if KERNELS_X86
+
+// AVX2: four doubles per register, four independent accumulators per loop
+const std::size_t AVX2_WIDTH = 4;
+
+KERNELS_AVX2 inline __m256d Load4(const double* p) { return _mm256_loadu_pd(p); }
+KERNELS_AVX2 inline __m256d Load4(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+
+KERNELS_AVX2 inline double HorizontalSum(__m256d v) {
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+KERNELS_AVX2 inline double HorizontalMin(__m256d v) {
+    __m128d pair = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_min_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+KERNELS_AVX2 inline double HorizontalMax(__m256d v) {
+    __m128d pair = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_max_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+template <class T>
+KERNELS_AVX2 double Avx2Sum(const T* values, std::size_t count) {
+    __m256d acc[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd()};
+    std::size_t i = 0;
+    for (; i + 4 * AVX2_WIDTH <= count; i += 4 * AVX2_WIDTH) {
+        for (int k = 0; k < 4; ++k) {
+            acc[k] = _mm256_add_pd(acc[k], Load4(values + i + k * AVX2_WIDTH));
+        }
+    }
+    for (; i + AVX2_WIDTH <= count; i += AVX2_WIDTH) {
+        acc[0] = _mm256_add_pd(acc[0], Load4(values + i));
+    }
+    __m256d total = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+    return HorizontalSum(total) + ScalarSum(values + i, count - i);
+}
+
+template <class T>
+KERNELS_AVX2 double Avx2SumSquares(const T* values, std::size_t count, double shift) {
+    const __m256d s = _mm256_set1_pd(shift);
+    __m256d acc[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd()};
+    std::size_t i = 0;
+    for (; i + 4 * AVX2_WIDTH <= count; i += 4 * AVX2_WIDTH) {
+        for (int k = 0; k < 4; ++k) {
+            __m256d d = _mm256_sub_pd(Load4(values + i + k * AVX2_WIDTH), s);
+            acc[k] = _mm256_fmadd_pd(d, d, acc[k]);
+        }
+    }
+    for (; i + AVX2_WIDTH <= count; i += AVX2_WIDTH) {
+        __m256d d = _mm256_sub_pd(Load4(values + i), s);
+        acc[0] = _mm256_fmadd_pd(d, d, acc[0]);
+    }
+    __m256d total = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+    return HorizontalSum(total) + ScalarSumSquares(values + i, count - i, shift);
+}
+
+template <class T>
+KERNELS_AVX2 double Avx2SumProducts(const T* x, const T* y, std::size_t count, double shiftX, double shiftY) {
+    const __m256d sx = _mm256_set1_pd(shiftX);
+    const __m256d sy = _mm256_set1_pd(shiftY);
+    __m256d acc[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd()};
+    std::size_t i = 0;
+    for (; i + 4 * AVX2_WIDTH <= count; i += 4 * AVX2_WIDTH) {
+        for (int k = 0; k < 4; ++k) {
+            __m256d dx = _mm256_sub_pd(Load4(x + i + k * AVX2_WIDTH), sx);
+            __m256d dy = _mm256_sub_pd(Load4(y + i + k * AVX2_WIDTH), sy);
+            acc[k] = _mm256_fmadd_pd(dx, dy, acc[k]);
+        }
+    }
+    for (; i + AVX2_WIDTH <= count; i += AVX2_WIDTH) {
+        __m256d dx = _mm256_sub_pd(Load4(x + i), sx);
+        __m256d dy = _mm256_sub_pd(Load4(y + i), sy);
+        acc[0] = _mm256_fmadd_pd(dx, dy, acc[0]);
+    }
+    __m256d total = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+    return HorizontalSum(total) + ScalarSumProducts(x + i, y + i, count - i, shiftX, shiftY);
+}
+
+template <class T>
+KERNELS_AVX2 double Avx2Min(const T* values, std::size_t count) {
+    __m256d acc = _mm256_set1_pd(INF);
+    std::size_t i = 0;
+    for (; i + AVX2_WIDTH <= count; i += AVX2_WIDTH) {
+        acc = _mm256_min_pd(acc, Load4(values + i));
+    }
+    double tail = ScalarMin(values + i, count - i);
+    double result = HorizontalMin(acc);
+    return tail < result ? tail : result;
+}
+
+template <class T>
+KERNELS_AVX2 double Avx2Max(const T* values, std::size_t count) {
+    __m256d acc = _mm256_set1_pd(-INF);
+    std::size_t i = 0;
+    for (; i + AVX2_WIDTH <= count; i += AVX2_WIDTH) {
+        acc = _mm256_max_pd(acc, Load4(values + i));
+    }
+    double tail = ScalarMax(values + i, count - i);
+    double result = HorizontalMax(acc);
+    return tail > result ? tail : result;
+}
+
+// AVX-512: eight doubles per register, four independent accumulators per loop
+// (GCC 12 reports its own _mm512_undefined_pd as uninitialised when inlined, see GCC bug 105593)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+const std::size_t AVX512_WIDTH = 8;
+
+KERNELS_AVX512 inline __m512d Load8(const double* p) { return _mm512_loadu_pd(p); }
+KERNELS_AVX512 inline __m512d Load8(const float* p) { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+
+// Fold the two halves of the register together and finish with the AVX2 reductions
+KERNELS_AVX512 inline double HorizontalSum(__m512d v) {
+    return HorizontalSum(_mm256_add_pd(_mm512_castpd512_pd256(v), _mm512_extractf64x4_pd(v, 1)));
+}
+
+KERNELS_AVX512 inline double HorizontalMin(__m512d v) {
+    return HorizontalMin(_mm256_min_pd(_mm512_castpd512_pd256(v), _mm512_extractf64x4_pd(v, 1)));
+}
+
+KERNELS_AVX512 inline double HorizontalMax(__m512d v) {
+    return HorizontalMax(_mm256_max_pd(_mm512_castpd512_pd256(v), _mm512_extractf64x4_pd(v, 1)));
+}
+
+template <class T>
+KERNELS_AVX512 double Avx512Sum(const T* values, std::size_t count) {
+    __m512d acc[4] = {_mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd()};
+    std::size_t i = 0;
+    for (; i + 4 * AVX512_WIDTH <= count; i += 4 * AVX512_WIDTH) {
+        for (int k = 0; k < 4; ++k) {
+            acc[k] = _mm512_add_pd(acc[k], Load8(values + i + k * AVX512_WIDTH));
+        }
+    }
+    for (; i + AVX512_WIDTH <= count; i += AVX512_WIDTH) {
+        acc[0] = _mm512_add_pd(acc[0], Load8(values + i));
+    }
+    __m512d total = _mm512_add_pd(_mm512_add_pd(acc[0], acc[1]), _mm512_add_pd(acc[2], acc[3]));
+    return HorizontalSum(total) + ScalarSum(values + i, count - i);
+}
+
+template <class T>
+KERNELS_AVX512 double Avx512SumSquares(const T* values, std::size_t count, double shift) {
+    const __m512d s = _mm512_set1_pd(shift);
+    __m512d acc[4] = {_mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd()};
+    std::size_t i = 0;
+    for (; i + 4 * AVX512_WIDTH <= count; i += 4 * AVX512_WIDTH) {
+        for (int k = 0; k < 4; ++k) {
+            __m512d d = _mm512_sub_pd(Load8(values + i + k * AVX512_WIDTH), s);
+            acc[k] = _mm512_fmadd_pd(d, d, acc[k]);
+        }
+    }
+    for (; i + AVX512_WIDTH <= count; i += AVX512_WIDTH) {
+        __m512d d = _mm512_sub_pd(Load8(values + i), s);
+        acc[0] = _mm512_fmadd_pd(d, d, acc[0]);
+    }
+    __m512d total = _mm512_add_pd(_mm512_add_pd(acc[0], acc[1]), _mm512_add_pd(acc[2], acc[3]));
+    return HorizontalSum(total) + ScalarSumSquares(values + i, count - i, shift);
+}
+
+template <class T>
+KERNELS_AVX512 double Avx512SumProducts(const T* x, const T* y, std::size_t count, double shiftX, double shiftY) {
+    const __m512d sx = _mm512_set1_pd(shiftX);
+    const __m512d sy = _mm512_set1_pd(shiftY);
+    __m512d acc[4] = {_mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd()};
+    std::size_t i = 0;
+    for (; i + 4 * AVX512_WIDTH <= count; i += 4 * AVX512_WIDTH) {
+        for (int k = 0; k < 4; ++k) {
+            __m512d dx = _mm512_sub_pd(Load8(x + i + k * AVX512_WIDTH), sx);
+            __m512d dy = _mm512_sub_pd(Load8(y + i + k * AVX512_WIDTH), sy);
+            acc[k] = _mm512_fmadd_pd(dx, dy, acc[k]);
+        }
+    }
+    for (; i + AVX512_WIDTH <= count; i += AVX512_WIDTH) {
+        __m512d dx = _mm512_sub_pd(Load8(x + i), sx);
+        __m512d dy = _mm512_sub_pd(Load8(y + i), sy);
+        acc[0] = _mm512_fmadd_pd(dx, dy, acc[0]);
+    }
+    __m512d total = _mm512_add_pd(_mm512_add_pd(acc[0], acc[1]), _mm512_add_pd(acc[2], acc[3]));
+    return HorizontalSum(total) + ScalarSumProducts(x + i, y + i, count - i, shiftX, shiftY);
+}
+
+template <class T>
+KERNELS_AVX512 double Avx512Min(const T* values, std::size_t count) {
+    __m512d acc = _mm512_set1_pd(INF);
+    std::size_t i = 0;
+    for (; i + AVX512_WIDTH <= count; i += AVX512_WIDTH) {
+        acc = _mm512_min_pd(acc, Load8(values + i));
+    }
+    double tail = ScalarMin(values + i, count - i);
+    double result = HorizontalMin(acc);
+    return tail < result ? tail : result;
+}
+
+template <class T>
+KERNELS_AVX512 double Avx512Max(const T* values, std::size_t count) {
+    __m512d acc = _mm512_set1_pd(-INF);
+    std::size_t i = 0;
+    for (; i + AVX512_WIDTH <= count; i += AVX512_WIDTH) {
+        acc = _mm512_max_pd(acc, Load8(values + i));
+    }
+    double tail = ScalarMax(values + i, count - i);
+    double result = HorizontalMax(acc);
+    return tail > result ? tail : result;
+}
+
+#pragma GCC diagnostic pop
+
+#endif // KERNELS_X86
+
+Kernels::Level Detect() {
+#if KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return Kernels::Level::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Kernels::Level::Avx2;
+    }
+#endif
+    return Kernels::Level::Scalar;
+}
+
+const Kernels::Level DETECTED_LEVEL = Detect();
+std::atomic<Kernels::Level> activeLevel(DETECTED_LEVEL);
+
+// Call the version of a kernel for the active level
+#if KERNELS_X86
+#define KERNELS_DISPATCH(name, ...)                                        \
+    switch (activeLevel.load(std::memory_order_relaxed)) {                 \
+        case Kernels::Level::Avx512: return Avx512##name(__VA_ARGS__);     \
+        case Kernels::Level::Avx2: return Avx2##name(__VA_ARGS__);         \
+        default: return Scalar##name(__VA_ARGS__);                         \
+    }
+#else
+#define KERNELS_DISPATCH(name, ...) return Scalar##name(__VA_ARGS__);
+#endif
+
+} // namespace
+
+Kernels::Level Kernels::DetectLevel() {
+    return DETECTED_LEVEL;
+}
+
+Kernels::Level Kernels::ActiveLevel() {
+    return activeLevel.load(std::memory_order_relaxed);
+}
+
+void Kernels::SetLevel(Level level) {
+    activeLevel.store(level > DETECTED_LEVEL ? DETECTED_LEVEL : level, std::memory_order_relaxed);
+}
+
+const char* Kernels::LevelName(Level level) {
+    switch (level) {
+        case Level::Avx512: return "avx512";
+        case Level::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+double Kernels::Sum(const double* values, std::size_t count) {
+    KERNELS_DISPATCH(Sum, values, count)
+}
+
+double Kernels::Sum(const float* values, std::size_t count) {
+    KERNELS_DISPATCH(Sum, values, count)
+}
+
+double Kernels::SumSquares(const double* values, std::size_t count, double shift) {
+    KERNELS_DISPATCH(SumSquares, values, count, shift)
+}
+
+double Kernels::SumSquares(const float* values, std::size_t count, double shift) {
+    KERNELS_DISPATCH(SumSquares, values, count, shift)
+}
+
+double Kernels::SumProducts(const double* x, const double* y, std::size_t count, double shiftX, double shiftY) {
+    KERNELS_DISPATCH(SumProducts, x, y, count, shiftX, shiftY)
+}
+
+double Kernels::SumProducts(const float* x, const float* y, std::size_t count, double shiftX, double shiftY) {
+    KERNELS_DISPATCH(SumProducts, x, y, count, shiftX, shiftY)
+}
+
+double Kernels::Min(const double* values, std::size_t count) {
+    KERNELS_DISPATCH(Min, values, count)
+}
+
+double Kernels::Min(const float* values, std::size_t count) {
+    KERNELS_DISPATCH(Min, values, count)
+}
+
+double Kernels::Max(const double* values, std::size_t count) {
+    KERNELS_DISPATCH(Max, values, count)
+}
+
+double Kernels::Max(const float* values, std::size_t count) {
+    KERNELS_DISPATCH(Max, values, count)
+}
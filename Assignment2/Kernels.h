@@ -0,0 +1,104 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cstddef>
+
+/**
+ * @brief Vectorised reductions over contiguous arrays of readings.
+ *
+ * Each kernel has a portable scalar version and, on x86 builds with GCC or Clang, AVX2 and
+ * AVX-512 versions. The fastest version the CPU supports is picked once at startup, so the
+ * same executable runs on any x86-64 machine. Float arrays are widened to double and all
+ * sums are accumulated in double.
+ *
+ * The vector versions add the values in a different order from the scalar loop, so sums
+ * may differ in the last bits: the results agree with the scalar version to within a
+ * relative error of KERNEL_TOLERANCE for arrays of up to a few million values. Min and Max
+ * are exact. The result for arrays containing NaN is unspecified.
+ */
+namespace Kernels {
+
+/**
+ * @brief The relative difference allowed between a vector and the scalar result of a sum.
+ */
+const double KERNEL_TOLERANCE = 1e-12;
+
+/**
+ * @brief The instruction sets a kernel can be run with, slowest first.
+ */
+enum class Level {
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+/**
+ * @brief Get the best level supported by this CPU and build.
+ * @return Level The detected level.
+ */
+Level DetectLevel();
+
+/**
+ * @brief Get the level the kernels currently run with.
+ * @return Level The active level, DetectLevel() unless changed with SetLevel.
+ */
+Level ActiveLevel();
+
+/**
+ * @brief Force the kernels to a level, for tests and benchmarks.
+ *
+ * @param level The level to run with. Levels above DetectLevel() are lowered to it.
+ */
+void SetLevel(Level level);
+
+/**
+ * @brief Get the name of a level.
+ * @param level The level.
+ * @return const char* "scalar", "avx2" or "avx512".
+ */
+const char* LevelName(Level level);
+
+/**
+ * @brief Compute the sum of an array.
+ * @return double The sum, 0 for an empty array.
+ */
+double Sum(const double* values, std::size_t count);
+double Sum(const float* values, std::size_t count);
+
+/**
+ * @brief Compute the sum of squared differences from a shift, Σ(x - shift)².
+ *
+ * With a shift of 0 this is the sum of squares. With the mean as the shift it is the sum of
+ * squared deviations used for the variance.
+ * @return double The sum, 0 for an empty array.
+ */
+double SumSquares(const double* values, std::size_t count, double shift = 0.0);
+double SumSquares(const float* values, std::size_t count, double shift = 0.0);
+
+/**
+ * @brief Compute the sum of products of differences from two shifts, Σ(x - shiftX)(y - shiftY).
+ *
+ * With shifts of 0 this is the sum of products. With the means as the shifts it is the
+ * co-moment used for the covariance.
+ * @return double The sum, 0 for empty arrays.
+ */
+double SumProducts(const double* x, const double* y, std::size_t count, double shiftX = 0.0, double shiftY = 0.0);
+double SumProducts(const float* x, const float* y, std::size_t count, double shiftX = 0.0, double shiftY = 0.0);
+
+/**
+ * @brief Find the smallest value of an array.
+ * @return double The minimum, +infinity for an empty array.
+ */
+double Min(const double* values, std::size_t count);
+double Min(const float* values, std::size_t count);
+
+/**
+ * @brief Find the largest value of an array.
+ * @return double The maximum, -infinity for an empty array.
+ */
+double Max(const double* values, std::size_t count);
+double Max(const float* values, std::size_t count);
+
+} // namespace Kernels
+
+#endif // KERNELS_H
@@ -1,13 +1,181 @@
+#include <cstdio>
 #include <iostream>
 #include <fstream>
+#include <memory>
 #include <sstream>
 #include <vector>
 #include <iomanip>
+#include <string>
 #include "Test.h"
 #include "WeatherData.h" // Include the header file for WeatherData class
 #include "Menu.h" // Include the header file for Menu class
+#include "QueryRunner.h"
+#include "QueryServer.h"
 
-int main() {
+int main(int argc, char* argv[]) {
+
+    // Number of threads used to load the data files (0 means one per hardware thread)
+    unsigned threadCount = 0;
+    // Binary snapshot read instead of the CSV files when still valid, and written after parsing
+    std::string snapshotPath;
+    // Binary snapshot written unconditionally after parsing the CSV files
+    std::string saveSnapshotPath;
+    // Keep reading lines appended to the data files while the menu runs
+    bool follow = false;
+    // Which reading to keep when overlapping files repeat a timestamp
+    DuplicatePolicy duplicatePolicy = DuplicatePolicy::KeepFirst;
+    // Store the readings as fixed-point integers instead of doubles
+    bool compact = false;
+    // Queries run without the menu, from --query and --batch in the order they are given
+    bool batch = false;
+    std::stringstream batchScript;
+    // File the batch results are written to instead of the standard output
+    std::string outputPath;
+    // Socket the queries are answered on instead of running the menu
+    std::string servePath;
+    // Socket of a running server and the request sent to it, without loading any data
+    std::string askPath;
+    std::string askRequest;
+    // Years whose reports are exported without the menu (empty for every year) and where they go
+    std::vector<int> exportYears;
+    std::string exportPath;
+    ExportLayout exportLayout = ExportLayout::PerYear;
+    // Readings or monthly statistics streamed without the menu, in a format, to a file or "-"
+    std::string streamContent;
+    std::string streamFormat;
+    std::string streamPath;
+    ExportFilter streamFilter;
+    // A date YYYY-MM-DD as the timestamp of its midnight; false if it is not a valid date
+    auto parseDate = [](const std::string& text, Timestamp& timestamp) {
+        int year, month, day;
+        char first, second, rest;
+        if (std::sscanf(text.c_str(), "%d%c%d%c%d%c", &year, &first, &month, &second, &day, &rest) != 5
+            || first != '-' || second != '-' || year < MIN_TIMESTAMP_YEAR || year > MAX_TIMESTAMP_YEAR
+            || !IsValidDate(year, month, day)) {
+            return false;
+        }
+        timestamp = MakeTimestamp(year, month, day);
+        return true;
+    };
+    // A whole number with nothing after it, as QueryRunner reads them; false if it is not one
+    auto parseNumber = [](const std::string& text, int& value) {
+        std::size_t used = 0;
+        try {
+            value = std::stoi(text, &used);
+        } catch (const std::exception&) {
+            return false;
+        }
+        return used == text.size();
+    };
+    // A year, or a range such as 2007-2009, of years a Timestamp can hold; false if it is not one
+    auto parseYears = [&parseNumber](const std::string& text, int& firstYear, int& lastYear) {
+        std::size_t dash = text.find('-', 1);
+        if (!parseNumber(text.substr(0, dash), firstYear)) {
+            return false;
+        }
+        lastYear = firstYear;
+        if (dash != std::string::npos && !parseNumber(text.substr(dash + 1), lastYear)) {
+            return false;
+        }
+        return firstYear >= MIN_TIMESTAMP_YEAR && lastYear <= MAX_TIMESTAMP_YEAR && firstYear <= lastYear;
+    };
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        int number = 0; // The value of an option that takes a number
+        if (argument == "--threads" && i + 1 < argc && parseNumber(argv[i + 1], number) && number >= 0) {
+            threadCount = static_cast<unsigned>(number);
+            ++i;
+        } else if (argument == "--snapshot" && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else if (argument == "--save-snapshot" && i + 1 < argc) {
+            saveSnapshotPath = argv[++i];
+        } else if (argument == "--follow") {
+            follow = true;
+        } else if (argument == "--compact") {
+            compact = true;
+        } else if (argument == "--query" && i + 1 < argc) {
+            batch = true;
+            batchScript << argv[++i] << '\n';
+        } else if (argument == "--batch" && i + 1 < argc) {
+            batch = true;
+            std::string scriptPath = argv[++i];
+            if (scriptPath == "-") {
+                batchScript << std::cin.rdbuf() << '\n';
+            } else {
+                std::ifstream scriptFile(scriptPath);
+                if (!scriptFile.is_open()) {
+                    std::cout << "Error opening query file: " << scriptPath << "\n";
+                    return 1;
+                }
+                batchScript << scriptFile.rdbuf() << '\n';
+            }
+        } else if (argument == "--output" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if ((argument == "--export" || argument == "--export-combined") && i + 2 < argc) {
+            // The years are "all" or a comma separated list such as 2007,2008
+            std::string years = argv[++i];
+            exportPath = argv[++i];
+            exportLayout = argument == "--export" ? ExportLayout::PerYear : ExportLayout::Combined;
+            std::stringstream yearList(years == "all" ? "" : years);
+            std::string year;
+            while (getline(yearList, year, ',')) {
+                int exportYear = 0;
+                if (!parseNumber(year, exportYear) || exportYear < MIN_TIMESTAMP_YEAR || exportYear > MAX_TIMESTAMP_YEAR) {
+                    std::cout << "Invalid export year: " << year << "\n";
+                    return 1;
+                }
+                exportYears.push_back(exportYear);
+            }
+        } else if (argument == "--stream" && i + 3 < argc && (std::string(argv[i + 1]) == "readings" || std::string(argv[i + 1]) == "months")) {
+            streamContent = argv[++i];
+            streamFormat = argv[++i];
+            streamPath = argv[++i];
+        } else if (argument == "--year" && i + 1 < argc && parseYears(argv[i + 1], streamFilter.firstYear, streamFilter.lastYear)) {
+            ++i;
+        } else if (argument == "--month" && i + 1 < argc && parseNumber(argv[i + 1], number) && number >= 1 && number <= 12) {
+            streamFilter.month = number;
+            ++i;
+        } else if (argument == "--from" && i + 1 < argc && parseDate(argv[i + 1], streamFilter.from)) {
+            ++i;
+        } else if (argument == "--to" && i + 1 < argc && parseDate(argv[i + 1], streamFilter.to)) {
+            // The day given is the last one included
+            streamFilter.to += MINUTES_PER_DAY;
+            ++i;
+        } else if (argument == "--serve" && i + 1 < argc) {
+            servePath = argv[++i];
+        } else if (argument == "--ask" && i + 2 < argc) {
+            askPath = argv[++i];
+            askRequest = argv[++i];
+        } else if (argument == "--duplicates" && i + 1 < argc && std::string(argv[i + 1]) == "first") {
+            duplicatePolicy = DuplicatePolicy::KeepFirst;
+            ++i;
+        } else if (argument == "--duplicates" && i + 1 < argc && std::string(argv[i + 1]) == "last") {
+            duplicatePolicy = DuplicatePolicy::KeepLast;
+            ++i;
+        } else if (argument == "--duplicates" && i + 1 < argc && std::string(argv[i + 1]) == "all") {
+            duplicatePolicy = DuplicatePolicy::KeepAll;
+            ++i;
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--threads N] [--snapshot FILE] [--save-snapshot FILE] [--follow] [--duplicates first|last|all] [--compact]\n"
+                      << "       [--query QUERY]... [--batch FILE|-]... [--output FILE]\n"
+                      << "       [--serve SOCKET] | [--ask SOCKET REQUEST]\n"
+                      << "       [--export all|YEAR,... DIR] [--export-combined all|YEAR,... FILE]\n"
+                      << "       [--stream readings|months csv|ndjson|binary FILE|-] [--year YEAR|FIRST-LAST] [--month M]\n"
+                      << "       [--from YYYY-MM-DD] [--to YYYY-MM-DD]\n";
+            return 1;
+        }
+    }
+
+    // Send one request to a running server and print its answer
+    if (!askPath.empty()) {
+        std::string reply;
+        bool answered = QueryServer::Ask(askPath, askRequest, reply);
+        std::cout << reply;
+        if (!answered) {
+            std::cout << "\n";
+        }
+        return answered ? 0 : 1;
+    }
 
     // Create a WeatherData object for handling data and BST
     WeatherData weatherData;
@@ -20,16 +188,91 @@ int main() {
     }
 
     std::string dataFilename;
+    std::vector<std::string> dataFilenames;
     while (getline(dataFile, dataFilename)) {
-        std::cout << "Load file: " << dataFilename << "\n";
-        if (!weatherData.LoadData("data/" + dataFilename)) {
-            std::cout << "Error loading file: " << dataFilename << "\n";
+        dataFilenames.push_back("data/" + dataFilename);
+    }
+
+    dataFile.close();
+
+    // Parse the files in parallel; they are merged in the order they are listed
+    weatherData.SetSnapshotPath(saveSnapshotPath.empty() ? snapshotPath : "");
+    weatherData.SetFollow(follow);
+    weatherData.SetDuplicatePolicy(duplicatePolicy);
+    weatherData.SetCompactStorage(compact);
+    // A stream to the standard output must not start with the loading messages
+    std::streambuf* consoleBuffer = std::cout.rdbuf();
+    if (streamPath == "-") {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+    bool loaded = weatherData.LoadFiles(dataFilenames, threadCount);
+    std::cout.rdbuf(consoleBuffer);
+    if (!loaded) {
+        std::cout << "Error loading data files\n";
+        return 1;
+    }
+
+    if (!saveSnapshotPath.empty()) {
+        if (!weatherData.SaveSnapshot(saveSnapshotPath, dataFilenames)) {
+            std::cout << "Error writing snapshot: " << saveSnapshotPath << "\n";
             return 1;
         }
+        std::cout << "Saved snapshot: " << saveSnapshotPath << "\n";
     }
 
-    dataFile.close();
+    // Write the reports of the chosen years and exit
+    if (!exportPath.empty()) {
+        return weatherData.ExportYears(exportYears, exportPath, exportLayout, threadCount) ? 0 : 1;
+    }
+
+    // Stream the chosen readings or months and exit
+    if (!streamContent.empty()) {
+        std::ofstream streamFile;
+        if (streamPath != "-") {
+            streamFile.open(streamPath, std::ios::binary);
+            if (!streamFile.is_open()) {
+                std::cout << "Error opening output file: " << streamPath << "\n";
+                return 1;
+            }
+        }
+        std::ostream& streamOut = streamPath == "-" ? std::cout : streamFile;
+        std::unique_ptr<ExportSink> sink = ExportSink::Create(streamFormat, streamOut);
+        if (!sink) {
+            std::cout << "Unknown export format: " << streamFormat << "\n";
+            return 1;
+        }
+        weatherData.StreamExport(streamFilter, streamContent == "readings" ? ExportSink::Content::Readings
+                                                                           : ExportSink::Content::Aggregates, *sink);
+        streamOut.flush();
+        return streamOut ? 0 : 1;
+    }
+
+    // Answer the queries without the menu; the timing summary goes to the error stream so the results can be piped
+    if (batch) {
+        std::ofstream outputFile;
+        if (!outputPath.empty()) {
+            outputFile.open(outputPath);
+            if (!outputFile.is_open()) {
+                std::cout << "Error opening output file: " << outputPath << "\n";
+                return 1;
+            }
+        }
+        QueryRunner runner(weatherData);
+        std::size_t errors = runner.RunScript(batchScript, outputPath.empty() ? std::cout : outputFile);
+        runner.PrintTimings(std::cerr);
+        return errors == 0 ? 0 : 1;
+    }
 
+    // Keep the data loaded and answer the queries of local clients until one asks the server to shut down
+    if (!servePath.empty()) {
+        QueryServer server(weatherData);
+        if (!server.Start(servePath)) {
+            return 1;
+        }
+        std::cout << "Serving queries on " << servePath << std::endl;
+        server.Run();
+        return 0;
+    }
 
     // Create a Menu object for handling user input and menu options
     Menu menu(weatherData);
@@ -0,0 +1,181 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_info(), m_open(false), m_file(nullptr), m_mapping(nullptr) {}
+#else
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_info(), m_open(false) {}
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+namespace {
+
+// Read the identity, size and modification time of an open file
+bool ReadInfo(HANDLE file, FileInfo& info) {
+    BY_HANDLE_FILE_INFORMATION details;
+    if (!GetFileInformationByHandle(file, &details)) {
+        return false;
+    }
+    // A FILETIME counts 100 ns steps since 1601
+    ULARGE_INTEGER ticks;
+    ticks.LowPart = details.ftLastWriteTime.dwLowDateTime;
+    ticks.HighPart = details.ftLastWriteTime.dwHighDateTime;
+    info.m_volume = details.dwVolumeSerialNumber;
+    info.m_index = (static_cast<std::uint64_t>(details.nFileIndexHigh) << 32) | details.nFileIndexLow;
+    info.m_size = (static_cast<std::uint64_t>(details.nFileSizeHigh) << 32) | details.nFileSizeLow;
+    info.m_modified = static_cast<std::int64_t>((ticks.QuadPart - 116444736000000000ull) / 10000000ull);
+    return true;
+}
+
+} // namespace
+
+bool MappedFile::Stat(const std::string& filename, FileInfo& info) {
+    HANDLE file = CreateFileA(filename.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, 0, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    bool found = ReadInfo(file, info);
+    CloseHandle(file);
+    return found;
+}
+
+// Map the file with the Win32 file mapping API
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    if (!ReadInfo(file, m_info)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_size = static_cast<std::size_t>(m_info.m_size);
+    m_open = true;
+
+    // A zero-length file cannot be mapped, but it is still a valid (empty) file
+    if (m_size == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        Close();
+        return false;
+    }
+    m_mapping = mapping;
+
+    m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+    }
+    if (m_file != nullptr) {
+        CloseHandle(static_cast<HANDLE>(m_file));
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_info = FileInfo();
+    m_open = false;
+    m_file = nullptr;
+    m_mapping = nullptr;
+}
+#else
+namespace {
+
+// Copy the identity, size and modification time out of a stat result
+void ReadInfo(const struct stat& details, FileInfo& info) {
+    info.m_volume = static_cast<std::uint64_t>(details.st_dev);
+    info.m_index = static_cast<std::uint64_t>(details.st_ino);
+    info.m_size = static_cast<std::uint64_t>(details.st_size);
+    info.m_modified = static_cast<std::int64_t>(details.st_mtime);
+}
+
+} // namespace
+
+bool MappedFile::Stat(const std::string& filename, FileInfo& info) {
+    struct stat details;
+    if (::stat(filename.c_str(), &details) != 0) {
+        return false;
+    }
+    ReadInfo(details, info);
+    return true;
+}
+
+// Map the file with mmap and tell the kernel we will read it front to back
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    ReadInfo(info, m_info);
+    m_size = static_cast<std::size_t>(info.st_size);
+    m_open = true;
+
+    // A zero-length file cannot be mapped, but it is still a valid (empty) file
+    if (m_size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference to the file
+    if (mapping == MAP_FAILED) {
+        m_size = 0;
+        m_info = FileInfo();
+        m_open = false;
+        return false;
+    }
+
+    ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char*>(mapping);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_info = FileInfo();
+    m_open = false;
+}
+#endif
@@ -0,0 +1,98 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Which file a name referred to when it was opened, with its size and modification time.
+ */
+struct FileInfo {
+    std::uint64_t m_volume; // The device (or volume serial number) the file is on
+    std::uint64_t m_index; // The inode (or file index) of the file on its volume
+    std::uint64_t m_size; // The size of the file in bytes
+    std::int64_t m_modified; // The last modification time of the file in seconds since 1970
+};
+
+/**
+ * @brief A read-only view of a whole file mapped into memory.
+ *
+ * The class maps a file with mmap (or CreateFileMapping on Windows) so the loader can
+ * tokenize the raw bytes in place instead of copying every line into a std::string.
+ * The mapping is released when the object is closed or destroyed.
+ */
+class MappedFile {
+private:
+    const char* m_data; // The first byte of the mapping (nullptr for an empty file)
+    std::size_t m_size; // The size of the mapping in bytes
+    FileInfo m_info; // The file that was mapped, as it was when it was opened
+    bool m_open; // True if a file is currently mapped
+#ifdef _WIN32
+    void* m_file; // The Windows file handle
+    void* m_mapping; // The Windows file mapping handle
+#endif
+
+public:
+    /**
+     * @brief Construct a new MappedFile object with no file mapped.
+     */
+    MappedFile();
+
+    /**
+     * @brief Unmap the file, if one is mapped.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map the whole file into memory for reading.
+     *
+     * @param filename The name of the file to be mapped.
+     * @return true If the file is successfully opened and mapped (an empty file maps to zero bytes).
+     * @return false If the file cannot be opened or mapped.
+     */
+    bool Open(const std::string& filename);
+
+    /**
+     * @brief Release the mapping and close the file.
+     */
+    void Close();
+
+    /**
+     * @brief Check if a file is currently mapped.
+     * @return true If a file is mapped.
+     */
+    bool IsOpen() const { return m_open; }
+
+    /**
+     * @brief Get the first byte of the mapped file.
+     * @return const char* The start of the mapping, or nullptr for an empty file.
+     */
+    const char* Data() const { return m_data; }
+
+    /**
+     * @brief Get the size of the mapped file.
+     * @return std::size_t The number of mapped bytes.
+     */
+    std::size_t Size() const { return m_size; }
+
+    /**
+     * @brief Get the identity, size and modification time of the file, read from the handle it was mapped from.
+     * @return const FileInfo& The file as it was when it was opened.
+     */
+    const FileInfo& Info() const { return m_info; }
+
+    /**
+     * @brief Read the identity, size and modification time of a file without mapping it.
+     *
+     * @param filename The name of the file.
+     * @param info Receives the file as it is now.
+     * @return true If the file exists.
+     */
+    static bool Stat(const std::string& filename, FileInfo& info);
+};
+
+#endif // MAPPEDFILE_H
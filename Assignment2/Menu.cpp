@@ -8,6 +8,7 @@ void Menu::DisplayMenu() {
     std::cout << "2. Average ambient air temperature and standard deviation for each month of a specified year\n";
     std::cout << "3. Sample Pearson Correlation Coefficient (sPCC) for specified month\n";
     std::cout << "4. Average wind speed, average ambient air temperature, and total solar radiation for each month of a specified year (write to file)\n";
+    std::cout << "5. Average wind speed, air temperature and solar radiation for each hour of the day in a specified month and year\n";
     std::cout << "6. Exit\n";
     std::cout << "Enter your choice: ";
 }
@@ -82,9 +83,26 @@ void Menu::ExecuteChoice(int choice) {
             } while (!validInput);
             wd.WriteDataToFile(yearInput);
             break;
-        case 5:
-            // Write code for bonus feature here
+        case 5: {
+            int month, yearInput;
+            do {
+                validInput = true;
+                std::cout << "Enter the month (" << MIN_MONTH << "-" << MAX_MONTH << "): ";
+                std::cin >> month;
+                if (!IsValidMonth(month)) {
+                    std::cout << "Invalid month. Please enter a number between " << MIN_MONTH << " and " << MAX_MONTH << "." << std::endl;
+                    validInput = false;
+                }
+                std::cout << "Enter the year: ";
+                std::cin >> yearInput;
+                if (!IsValidYear(yearInput, wd.GetCurrentYear())) {
+                    std::cout << "Invalid year. Please enter a positive number up to " << wd.GetCurrentYear() << "." << std::endl;
+                    validInput = false;
+                }
+            } while (!validInput);
+            wd.PrintDiurnalProfile(month, yearInput);
             break;
+        }
         case 6:
             running = false;
             std::cout << "Thank You. Goodbye! ";
@@ -99,6 +117,11 @@ void Menu::Run() {
     int choice;
 
     while (running) {
+        // pick up any readings appended to followed files since the last choice
+        std::size_t added = wd.PollFollowedFiles();
+        if (added > 0) {
+            std::cout << "\nLoaded " << added << " new readings" << std::endl;
+        }
         DisplayMenu();
         std::cin >> choice;
         ExecuteChoice(choice);
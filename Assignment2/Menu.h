@@ -45,6 +45,8 @@ public:
 
     /**
      * @brief Run the main loop of the program, asking for the year and the menu choice until the user exits.
+     *
+     * Before each menu is shown, lines appended to followed files are loaded.
      */
     void Run();
 
@@ -0,0 +1,15 @@
+#ifndef METRIC_H
+#define METRIC_H
+
+/**
+ * @brief The sensor measurements kept for each reading.
+ */
+enum class Metric {
+    WindSpeed,
+    Temperature,
+    SolarRadiation
+};
+
+const int METRIC_COUNT = 3;
+
+#endif // METRIC_H
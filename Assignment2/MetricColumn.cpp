@@ -0,0 +1,190 @@
+#include "MetricColumn.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// The scales Compact tries, smallest first
+const double SCALES[] = {1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0};
+
+// Widen count fixed-point values starting at values into out
+template <class T>
+void WidenValues(const T* values, std::size_t count, double scale, double* out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = values[i] / scale;
+    }
+}
+
+template <class T>
+void PermuteValues(std::vector<T>& values, const std::vector<std::size_t>& order) {
+    std::vector<T> permuted;
+    permuted.reserve(values.size());
+    for (std::size_t index : order) {
+        permuted.push_back(values[index]);
+    }
+    values.swap(permuted);
+}
+
+} // namespace
+
+MetricColumn::MetricColumn() : m_encoding(Encoding::Double), m_scale(1.0), m_doubles(), m_fixed16(), m_fixed32() {}
+
+// Both 0 and -0 give 0, so a negative zero is kept as a double to keep its sign
+bool MetricColumn::Quantise(double value, double scale, std::int32_t& fixed) {
+    double scaled = std::nearbyint(value * scale);
+    if (!(std::fabs(scaled) <= std::numeric_limits<std::int32_t>::max()) || (value == 0.0 && std::signbit(value))) {
+        return false;
+    }
+    fixed = static_cast<std::int32_t>(scaled);
+    return fixed / scale == value;
+}
+
+void MetricColumn::Widen() {
+    std::vector<double> values(Size());
+    Read(0, values.size(), values.data());
+    m_doubles.swap(values);
+    m_fixed16 = std::vector<std::int16_t>();
+    m_fixed32 = std::vector<std::int32_t>();
+    m_encoding = Encoding::Double;
+    m_scale = 1.0;
+}
+
+std::size_t MetricColumn::Size() const {
+    switch (m_encoding) {
+        case Encoding::Fixed16: return m_fixed16.size();
+        case Encoding::Fixed32: return m_fixed32.size();
+        default: return m_doubles.size();
+    }
+}
+
+std::size_t MetricColumn::Bytes() const {
+    switch (m_encoding) {
+        case Encoding::Fixed16: return m_fixed16.capacity() * sizeof(std::int16_t);
+        case Encoding::Fixed32: return m_fixed32.capacity() * sizeof(std::int32_t);
+        default: return m_doubles.capacity() * sizeof(double);
+    }
+}
+
+void MetricColumn::Reserve(std::size_t count) {
+    switch (m_encoding) {
+        case Encoding::Fixed16: m_fixed16.reserve(count); break;
+        case Encoding::Fixed32: m_fixed32.reserve(count); break;
+        default: m_doubles.reserve(count); break;
+    }
+}
+
+void MetricColumn::PushBack(double value) {
+    std::int32_t fixed = 0;
+    if (m_encoding != Encoding::Double && !Quantise(value, m_scale, fixed)) {
+        Widen();
+    }
+    if (m_encoding == Encoding::Fixed16 && fixed >= std::numeric_limits<std::int16_t>::min() && fixed <= std::numeric_limits<std::int16_t>::max()) {
+        m_fixed16.push_back(static_cast<std::int16_t>(fixed));
+    } else if (m_encoding == Encoding::Fixed16) {
+        // The value needs more than 16 bits at this scale
+        m_fixed32.assign(m_fixed16.begin(), m_fixed16.end());
+        m_fixed32.push_back(fixed);
+        m_fixed16 = std::vector<std::int16_t>();
+        m_encoding = Encoding::Fixed32;
+    } else if (m_encoding == Encoding::Fixed32) {
+        m_fixed32.push_back(fixed);
+    } else {
+        m_doubles.push_back(value);
+    }
+}
+
+// Move the values of another column to the end of this one
+void MetricColumn::Append(MetricColumn& other) {
+    if (Empty()) {
+        std::swap(*this, other);
+    } else if (m_encoding == Encoding::Double && other.m_encoding == Encoding::Double) {
+        m_doubles.insert(m_doubles.end(), other.m_doubles.begin(), other.m_doubles.end());
+    } else {
+        Reserve(Size() + other.Size());
+        for (std::size_t i = 0; i < other.Size(); ++i) {
+            PushBack(other[i]);
+        }
+    }
+    other = MetricColumn();
+}
+
+void MetricColumn::Assign(const double* values, std::size_t count) {
+    *this = MetricColumn();
+    m_doubles.assign(values, values + count);
+}
+
+void MetricColumn::Permute(const std::vector<std::size_t>& order) {
+    switch (m_encoding) {
+        case Encoding::Fixed16: PermuteValues(m_fixed16, order); break;
+        case Encoding::Fixed32: PermuteValues(m_fixed32, order); break;
+        default: PermuteValues(m_doubles, order); break;
+    }
+}
+
+void MetricColumn::CopyValue(std::size_t to, std::size_t from) {
+    switch (m_encoding) {
+        case Encoding::Fixed16: m_fixed16[to] = m_fixed16[from]; break;
+        case Encoding::Fixed32: m_fixed32[to] = m_fixed32[from]; break;
+        default: m_doubles[to] = m_doubles[from]; break;
+    }
+}
+
+void MetricColumn::Resize(std::size_t count) {
+    switch (m_encoding) {
+        case Encoding::Fixed16: m_fixed16.resize(count); break;
+        case Encoding::Fixed32: m_fixed32.resize(count); break;
+        default: m_doubles.resize(count); break;
+    }
+}
+
+// Find the smallest scale that keeps every value exact, then the narrowest integer that holds them
+bool MetricColumn::Compact() {
+    if (m_encoding != Encoding::Double) {
+        return true;
+    }
+
+    for (double scale : SCALES) {
+        std::vector<std::int32_t> fixed(m_doubles.size());
+        bool exact = true;
+        bool narrow = true;
+        for (std::size_t i = 0; i < m_doubles.size() && exact; ++i) {
+            exact = Quantise(m_doubles[i], scale, fixed[i]);
+            narrow = narrow && fixed[i] >= std::numeric_limits<std::int16_t>::min() && fixed[i] <= std::numeric_limits<std::int16_t>::max();
+        }
+        if (!exact) {
+            continue;
+        }
+
+        if (narrow) {
+            m_fixed16.assign(fixed.begin(), fixed.end());
+            m_encoding = Encoding::Fixed16;
+        } else {
+            m_fixed32.swap(fixed);
+            m_encoding = Encoding::Fixed32;
+        }
+        m_doubles = std::vector<double>();
+        m_scale = scale;
+        return true;
+    }
+    return false;
+}
+
+void MetricColumn::Expand() {
+    if (m_encoding != Encoding::Double) {
+        Widen();
+    }
+}
+
+void MetricColumn::Read(std::size_t first, std::size_t count, double* out) const {
+    switch (m_encoding) {
+        case Encoding::Fixed16: WidenValues(m_fixed16.data() + first, count, m_scale, out); break;
+        case Encoding::Fixed32: WidenValues(m_fixed32.data() + first, count, m_scale, out); break;
+        default:
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = m_doubles[first + i];
+            }
+            break;
+    }
+}
@@ -0,0 +1,252 @@
+#ifndef METRICCOLUMN_H
+#define METRICCOLUMN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/**
+ * @brief The values of one metric for every reading of a year, stored as doubles or as fixed-point integers.
+ *
+ * A column starts out holding doubles. Compact then looks for the smallest decimal scale
+ * (1, 10, ..., 1000000) at which every value is an integer, and stores the values as
+ * value * scale in 16-bit integers if they fit, or in 32-bit integers otherwise. A value is
+ * only quantised if dividing the integer by the scale gives back the same double, so
+ * reading a compact column always returns exactly the values that were stored. A column
+ * with a value that cannot be stored this way, such as a NaN, stays as doubles.
+ *
+ * Values added to a compact column are encoded with its current scale. If one does not fit,
+ * the whole column is widened back to doubles until the next call to Compact.
+ */
+class MetricColumn {
+public:
+    /**
+     * @brief How the values of a column are held in memory.
+     */
+    enum class Encoding {
+        Double,
+        Fixed16,
+        Fixed32
+    };
+
+private:
+    Encoding m_encoding; // The array that holds the values
+    double m_scale; // The number each fixed-point value was multiplied by (1 for doubles)
+    std::vector<double> m_doubles; // The values, when the encoding is Double
+    std::vector<std::int16_t> m_fixed16; // The values times the scale, when the encoding is Fixed16
+    std::vector<std::int32_t> m_fixed32; // The values times the scale, when the encoding is Fixed32
+
+    /**
+     * @brief Quantise a value at a scale.
+     *
+     * @param value The value.
+     * @param scale The scale.
+     * @param fixed Receives round(value * scale).
+     * @return true If fixed fits in 32 bits and fixed / scale is exactly the value.
+     */
+    static bool Quantise(double value, double scale, std::int32_t& fixed);
+
+    /**
+     * @brief Move every value into m_doubles and make the encoding Double.
+     */
+    void Widen();
+
+public:
+    /**
+     * @brief Construct an empty column of doubles.
+     */
+    MetricColumn();
+
+    std::size_t Size() const;
+    bool Empty() const { return Size() == 0; }
+    Encoding GetEncoding() const { return m_encoding; }
+    double Scale() const { return m_scale; }
+
+    /**
+     * @brief Get the number of bytes allocated for the values.
+     * @return std::size_t The capacity of the array in use times its element size.
+     */
+    std::size_t Bytes() const;
+
+    /**
+     * @brief Reserve room for a number of values.
+     * @param count The total number of values to reserve.
+     */
+    void Reserve(std::size_t count);
+
+    /**
+     * @brief Append one value, widening the column to doubles if the value cannot be encoded.
+     * @param value The value.
+     */
+    void PushBack(double value);
+
+    /**
+     * @brief Append every value of another column, leaving it empty.
+     * @param other The column to be moved to the end of this one.
+     */
+    void Append(MetricColumn& other);
+
+    /**
+     * @brief Replace every value with doubles copied from an array. The column holds doubles afterwards.
+     *
+     * @param values The values.
+     * @param count The number of values.
+     */
+    void Assign(const double* values, std::size_t count);
+
+    /**
+     * @brief Reorder the values, keeping their encoding.
+     * @param order The old index of the value that goes to each new index.
+     */
+    void Permute(const std::vector<std::size_t>& order);
+
+    /**
+     * @brief Copy the value at one index over the value at another, keeping the encoding.
+     *
+     * @param to The index that is overwritten.
+     * @param from The index that is read.
+     */
+    void CopyValue(std::size_t to, std::size_t from);
+
+    /**
+     * @brief Shrink or grow the column. New values are 0.
+     * @param count The new number of values.
+     */
+    void Resize(std::size_t count);
+
+    /**
+     * @brief Store the values in the narrowest fixed-point encoding that keeps them exact.
+     *
+     * A column that is already fixed-point is left as it is.
+     *
+     * @return true If the column is fixed-point afterwards.
+     */
+    bool Compact();
+
+    /**
+     * @brief Store the values as doubles again.
+     */
+    void Expand();
+
+    /**
+     * @brief Get one value, widened to double.
+     * @param index The index of the value.
+     * @return double The value.
+     */
+    double operator[](std::size_t index) const {
+        switch (m_encoding) {
+            case Encoding::Fixed16: return m_fixed16[index] / m_scale;
+            case Encoding::Fixed32: return m_fixed32[index] / m_scale;
+            default: return m_doubles[index];
+        }
+    }
+
+    /**
+     * @brief Widen a run of values into an array of doubles.
+     *
+     * @param first The index of the first value.
+     * @param count The number of values.
+     * @param out The array that receives the values.
+     */
+    void Read(std::size_t first, std::size_t count, double* out) const;
+
+    /**
+     * @brief Get the values as an array of doubles without copying.
+     * @return const double* The values, or nullptr if the column is fixed-point.
+     */
+    const double* Doubles() const { return m_encoding == Encoding::Double ? m_doubles.data() : nullptr; }
+};
+
+/**
+ * @brief A non-owning, read-only view of a run of values of a MetricColumn.
+ *
+ * The view reads values as doubles whatever the encoding of the column. Code that works on
+ * arrays, such as the kernels, can take Doubles() directly when the column holds doubles,
+ * and otherwise widen blocks of values with Read. The column must outlive the view.
+ */
+class ColumnSpan {
+private:
+    const MetricColumn* m_column; // The column the values belong to (nullptr for an empty view)
+    std::size_t m_offset; // The index of the first value of the view
+    std::size_t m_size; // The number of values in the view
+
+public:
+    /**
+     * @brief An iterator that yields the values of the view as doubles.
+     */
+    class Iterator {
+    private:
+        const MetricColumn* m_column;
+        std::size_t m_index;
+
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef double value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const double* pointer;
+        typedef double reference;
+
+        Iterator(const MetricColumn* column, std::size_t index) : m_column(column), m_index(index) {}
+        double operator*() const { return (*m_column)[m_index]; }
+        Iterator& operator++() { ++m_index; return *this; }
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+    };
+
+    /**
+     * @brief Construct an empty view.
+     */
+    ColumnSpan() : m_column(nullptr), m_offset(0), m_size(0) {}
+
+    /**
+     * @brief Construct a view of every value of a column.
+     */
+    ColumnSpan(const MetricColumn& column) : m_column(&column), m_offset(0), m_size(column.Size()) {}
+
+    /**
+     * @brief Construct a view of count values of a column starting at offset.
+     */
+    ColumnSpan(const MetricColumn& column, std::size_t offset, std::size_t count) : m_column(&column), m_offset(offset), m_size(count) {}
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    Iterator begin() const { return Iterator(m_column, m_offset); }
+    Iterator end() const { return Iterator(m_column, m_offset + m_size); }
+    double operator[](std::size_t index) const { return (*m_column)[m_offset + index]; }
+
+    /**
+     * @brief Get a view of part of this view.
+     *
+     * @param offset The index of the first value of the part.
+     * @param count The number of values in the part.
+     * @return ColumnSpan The view of values [offset, offset + count).
+     */
+    ColumnSpan Subspan(std::size_t offset, std::size_t count) const {
+        return m_column == nullptr ? ColumnSpan() : ColumnSpan(*m_column, m_offset + offset, count);
+    }
+
+    /**
+     * @brief Widen a run of values of the view into an array of doubles.
+     *
+     * @param first The index in the view of the first value.
+     * @param count The number of values.
+     * @param out The array that receives the values.
+     */
+    void Read(std::size_t first, std::size_t count, double* out) const {
+        if (count > 0) {
+            m_column->Read(m_offset + first, count, out);
+        }
+    }
+
+    /**
+     * @brief Get the values of the view as an array of doubles without copying.
+     * @return const double* The values, or nullptr if the column is fixed-point.
+     */
+    const double* Doubles() const {
+        const double* values = m_column == nullptr ? nullptr : m_column->Doubles();
+        return values == nullptr ? nullptr : values + m_offset;
+    }
+};
+
+#endif // METRICCOLUMN_H
@@ -0,0 +1,144 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A slab allocator for objects of one type, such as the nodes of a tree.
+ *
+ * Objects are carved out of slabs that each hold many of them, so creating n objects costs
+ * O(log n) heap allocations instead of n. The first slab holds FIRST_SLAB objects and each
+ * new slab is twice as large, up to MAX_SLAB. Destroyed objects go onto a free list and
+ * their memory is reused by the next Create. The memory of every slab is returned at once
+ * by Clear or the destructor, which do not run the destructors of objects still alive.
+ *
+ * @tparam T The type of the objects.
+ */
+template <class T>
+class NodePool {
+private:
+    union Slot {
+        Slot* next; // The next free slot, while the slot is on the free list
+        alignas(T) unsigned char storage[sizeof(T)]; // The object, while it is alive
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> m_slabs; // Every slab allocated, oldest first
+    Slot* m_free; // The most recently released slot (nullptr if none)
+    Slot* m_unused; // The first slot of the newest slab that has never been handed out
+    std::size_t m_remaining; // The number of slots from m_unused to the end of the newest slab
+    std::size_t m_nextSlab; // The size of the next slab
+
+    void AddSlab(std::size_t slots) {
+        m_slabs.emplace_back(new Slot[slots]);
+        m_unused = m_slabs.back().get();
+        m_remaining = slots;
+        m_nextSlab = slots < MAX_SLAB / 2 ? slots * 2 : MAX_SLAB;
+    }
+
+public:
+    static const std::size_t FIRST_SLAB = 64; // The number of objects in the first slab
+    static const std::size_t MAX_SLAB = 65536; // The largest number of objects in a slab that grows on its own
+
+    NodePool() : m_slabs(), m_free(nullptr), m_unused(nullptr), m_remaining(0), m_nextSlab(FIRST_SLAB) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    NodePool(NodePool&& other) noexcept : NodePool() {
+        Swap(other);
+    }
+
+    NodePool& operator=(NodePool&& other) noexcept {
+        NodePool moved(std::move(other));
+        Swap(moved);
+        return *this;
+    }
+
+    /**
+     * @brief Exchange the slabs of two pools, so each takes over the objects of the other.
+     * @param other The pool to be swapped with.
+     */
+    void Swap(NodePool& other) noexcept {
+        m_slabs.swap(other.m_slabs);
+        std::swap(m_free, other.m_free);
+        std::swap(m_unused, other.m_unused);
+        std::swap(m_remaining, other.m_remaining);
+        std::swap(m_nextSlab, other.m_nextSlab);
+    }
+
+    /**
+     * @brief Make sure the next count objects can be created without freed slots and without another allocation.
+     *
+     * A new slab of exactly count objects is allocated if the newest slab has less room left.
+     *
+     * @param count The number of objects about to be created.
+     */
+    void Reserve(std::size_t count) {
+        if (m_remaining < count) {
+            std::size_t next = m_nextSlab;
+            AddSlab(count);
+            m_nextSlab = next;
+        }
+    }
+
+    /**
+     * @brief Create an object in a free slot.
+     * @param args The arguments of the constructor of T.
+     * @return T* The new object.
+     */
+    template <class... Args>
+    T* Create(Args&&... args) {
+        Slot* slot;
+        if (m_free != nullptr) {
+            slot = m_free;
+            m_free = slot->next;
+        } else {
+            if (m_remaining == 0) {
+                AddSlab(m_nextSlab);
+            }
+            slot = m_unused++;
+            --m_remaining;
+        }
+        try {
+            return ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            slot->next = m_free;
+            m_free = slot;
+            throw;
+        }
+    }
+
+    /**
+     * @brief Destroy an object created by this pool and keep its slot for reuse.
+     * @param object The object.
+     */
+    void Destroy(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = m_free;
+        m_free = slot;
+    }
+
+    /**
+     * @brief Free every slab. Objects still alive are dropped without running their destructors.
+     */
+    void Clear() {
+        m_slabs.clear();
+        m_free = nullptr;
+        m_unused = nullptr;
+        m_remaining = 0;
+        m_nextSlab = FIRST_SLAB;
+    }
+
+    /**
+     * @brief Get the number of slabs allocated, which is the number of heap allocations made for objects.
+     * @return std::size_t The slab count.
+     */
+    std::size_t SlabCount() const { return m_slabs.size(); }
+};
+
+#endif // NODEPOOL_H
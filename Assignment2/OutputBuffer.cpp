@@ -0,0 +1,82 @@
+#include "OutputBuffer.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// Room for any 64-bit integer, and for any double with up to 80 decimals (1e308 has 309 digits before the point)
+const std::size_t NUMBER_ROOM = 400;
+
+} // namespace
+
+OutputBuffer::OutputBuffer(std::ostream& out) : m_out(out), m_buffer(new char[CAPACITY]), m_size(0), m_flushed(0) {}
+
+OutputBuffer::~OutputBuffer() {
+    Flush();
+}
+
+char* OutputBuffer::Reserve(std::size_t count) {
+    if (m_size + count > CAPACITY) {
+        Flush();
+    }
+    return m_buffer.get() + m_size;
+}
+
+void OutputBuffer::Flush() {
+    if (m_size > 0) {
+        m_out.write(m_buffer.get(), static_cast<std::streamsize>(m_size));
+        m_flushed += m_size;
+        m_size = 0;
+    }
+}
+
+OutputBuffer& OutputBuffer::Write(std::string_view text) {
+    // Text larger than the buffer goes straight to the stream after what is buffered
+    if (text.size() > CAPACITY) {
+        Flush();
+        m_out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        m_flushed += text.size();
+        return *this;
+    }
+    std::memcpy(Reserve(text.size()), text.data(), text.size());
+    m_size += text.size();
+    return *this;
+}
+
+OutputBuffer& OutputBuffer::Write(char c) {
+    *Reserve(1) = c;
+    ++m_size;
+    return *this;
+}
+
+OutputBuffer& OutputBuffer::Write(long long value) {
+    char* first = Reserve(NUMBER_ROOM);
+    m_size += static_cast<std::size_t>(std::to_chars(first, first + NUMBER_ROOM, value).ptr - first);
+    return *this;
+}
+
+OutputBuffer& OutputBuffer::WriteGeneral(double value, int precision) {
+    char* first = Reserve(NUMBER_ROOM);
+    m_size += static_cast<std::size_t>(std::to_chars(first, first + NUMBER_ROOM, value, std::chars_format::general, precision).ptr - first);
+    return *this;
+}
+
+OutputBuffer& OutputBuffer::WriteShortest(double value) {
+    char* first = Reserve(NUMBER_ROOM);
+    m_size += static_cast<std::size_t>(std::to_chars(first, first + NUMBER_ROOM, value).ptr - first);
+    return *this;
+}
+
+OutputBuffer& OutputBuffer::WriteFixed(double value, int precision) {
+    char* first = Reserve(NUMBER_ROOM);
+    m_size += static_cast<std::size_t>(std::to_chars(first, first + NUMBER_ROOM, value, std::chars_format::fixed, precision).ptr - first);
+    return *this;
+}
+
+OutputBuffer& OutputBuffer::PadTo(std::size_t start, std::size_t width) {
+    while (Position() - start < width) {
+        Write(' ');
+    }
+    return *this;
+}
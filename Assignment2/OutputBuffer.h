@@ -0,0 +1,116 @@
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+/**
+ * @brief A buffered writer of text and numbers for large outputs such as tables and CSV files.
+ *
+ * Text is gathered in a block of CAPACITY bytes, which is handed to the stream in one write
+ * when it is full, when Flush is called and when the buffer is destroyed. Nothing is flushed
+ * per line. Numbers are converted with std::to_chars, so no locale or stream state is involved,
+ * and they come out exactly as the stream manipulators would print them:
+ * WriteGeneral as a stream with default formatting, WriteFixed as std::fixed with setprecision.
+ */
+class OutputBuffer {
+public:
+    /**
+     * @brief The size of the block handed to the stream.
+     */
+    static const std::size_t CAPACITY = 1 << 16;
+
+    /**
+     * @brief Construct a buffer in front of a stream.
+     * @param out The stream the text is written to.
+     */
+    explicit OutputBuffer(std::ostream& out);
+
+    /**
+     * @brief Write what is left in the buffer to the stream.
+     */
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    /**
+     * @brief Append text.
+     * @param text The text.
+     * @return OutputBuffer& This buffer.
+     */
+    OutputBuffer& Write(std::string_view text);
+
+    /**
+     * @brief Append one character.
+     * @param c The character.
+     * @return OutputBuffer& This buffer.
+     */
+    OutputBuffer& Write(char c);
+
+    /**
+     * @brief Append an integer in decimal.
+     * @param value The integer.
+     * @return OutputBuffer& This buffer.
+     */
+    OutputBuffer& Write(long long value);
+
+    /**
+     * @brief Append a number the way a stream with default formatting prints it (printf "%g").
+     * @param value The number.
+     * @param precision The number of significant digits, 6 by default like a stream.
+     * @return OutputBuffer& This buffer.
+     */
+    OutputBuffer& WriteGeneral(double value, int precision = 6);
+
+    /**
+     * @brief Append a number in the shortest form that reads back as exactly the same double.
+     * @param value The number.
+     * @return OutputBuffer& This buffer.
+     */
+    OutputBuffer& WriteShortest(double value);
+
+    /**
+     * @brief Append a number with a fixed number of decimals, like std::fixed and std::setprecision.
+     * @param value The number.
+     * @param precision The number of digits after the decimal point (at most 80).
+     * @return OutputBuffer& This buffer.
+     */
+    OutputBuffer& WriteFixed(double value, int precision);
+
+    /**
+     * @brief Get the number of characters appended so far, for use with PadTo.
+     * @return std::size_t The count.
+     */
+    std::size_t Position() const { return m_flushed + m_size; }
+
+    /**
+     * @brief Append spaces until the text since a position is a given width wide, like std::setw with std::left.
+     * @param start The position returned by Position before the text was appended.
+     * @param width The width of the field.
+     * @return OutputBuffer& This buffer.
+     */
+    OutputBuffer& PadTo(std::size_t start, std::size_t width);
+
+    /**
+     * @brief Hand the buffered text to the stream. The stream itself is not flushed.
+     */
+    void Flush();
+
+private:
+    std::ostream& m_out; // The stream the text is written to
+    std::unique_ptr<char[]> m_buffer; // The block of CAPACITY bytes
+    std::size_t m_size; // The number of bytes in the buffer
+    std::size_t m_flushed; // The number of bytes already handed to the stream
+
+    /**
+     * @brief Make room for a number of bytes, flushing if they do not fit after the buffered text.
+     * @param count The number of bytes about to be appended (at most CAPACITY).
+     * @return char* Where they go.
+     */
+    char* Reserve(std::size_t count);
+};
+
+#endif // OUTPUTBUFFER_H
@@ -0,0 +1,164 @@
+#include "QueryRunner.h"
+
+#include <sstream>
+
+namespace {
+
+const char* const COMMANDS[] = { "wind", "temperature", "spcc", "export", "hourly", "solar" };
+
+// Read one integer argument; false if it is missing or not a whole number
+bool ReadNumber(std::istringstream& arguments, int& value) {
+    std::string word;
+    if (!(arguments >> word)) {
+        return false;
+    }
+    std::size_t used = 0;
+    try {
+        value = std::stoi(word, &used);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return used == word.size();
+}
+
+} // namespace
+
+const char* const QueryRunner::DEFAULT_EXPORT_PATH = "data/WindTempSolar.csv";
+
+QueryRunner::QueryRunner(WeatherData& wdInput) : wd(wdInput), m_timings(), m_errors(0) {}
+
+const char* QueryRunner::CommandName(Kind kind) {
+    return COMMANDS[static_cast<std::size_t>(kind)];
+}
+
+bool QueryRunner::Parse(const std::string& line, Query& query, std::string& error) {
+    error.clear();
+    std::istringstream arguments(line);
+    std::string command;
+    if (!(arguments >> command) || command[0] == '#') {
+        return false;
+    }
+
+    query = Query{ Kind::Count, 0, 0, "" };
+    for (std::size_t kind = 0; kind < static_cast<std::size_t>(Kind::Count); ++kind) {
+        if (command == COMMANDS[kind]) {
+            query.kind = static_cast<Kind>(kind);
+        }
+    }
+    if (query.kind == Kind::Count) {
+        error = "unknown command " + command;
+        return false;
+    }
+
+    // The same checks as the menu: months 1-12 and years from 0 to the current year
+    const bool hasMonth = query.kind == Kind::Wind || query.kind == Kind::Correlation || query.kind == Kind::Hourly;
+    const bool hasYear = query.kind != Kind::Correlation;
+    if (hasMonth && (!ReadNumber(arguments, query.month) || query.month < 1 || query.month > 12)) {
+        error = command + " needs a month between 1 and 12";
+        return false;
+    }
+    if (hasYear && (!ReadNumber(arguments, query.year) || query.year < 0 || query.year > WeatherData::GetCurrentYear())) {
+        error = command + " needs a year up to " + std::to_string(WeatherData::GetCurrentYear());
+        return false;
+    }
+    if (query.kind == Kind::Export && !(arguments >> query.path)) {
+        query.path = DEFAULT_EXPORT_PATH;
+    }
+
+    std::string extra;
+    if (arguments >> extra) {
+        error = "unexpected argument " + extra;
+        return false;
+    }
+    return true;
+}
+
+void QueryRunner::Execute(const Query& query, std::ostream& out) {
+    switch (query.kind) {
+        case Kind::Wind:
+            wd.PrintAverageWindSpeed(query.month, query.year, out);
+            break;
+        case Kind::Temperature:
+            wd.PrintAverageTemperature(query.year, out);
+            break;
+        case Kind::Correlation:
+            wd.CalculateSPCC(query.month, out);
+            break;
+        case Kind::Export:
+            wd.WriteDataToFile(query.year, query.path, out);
+            break;
+        case Kind::Hourly:
+            wd.PrintDiurnalProfile(query.month, query.year, out);
+            break;
+        case Kind::Solar:
+            wd.PrintSolarRadiation(query.year, out);
+            break;
+        case Kind::Count:
+            break;
+    }
+}
+
+bool QueryRunner::Run(const std::string& line, std::ostream& out) {
+    Query query;
+    std::string error;
+    if (!Parse(line, query, error)) {
+        if (error.empty()) {
+            return true;
+        }
+        out << "Invalid query: " << line << " (" << error << ")" << std::endl;
+        ++m_errors;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Execute(query, out);
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+
+    Timing& timing = m_timings[static_cast<std::size_t>(query.kind)];
+    ++timing.count;
+    timing.total += elapsed;
+    if (elapsed > timing.longest) {
+        timing.longest = elapsed;
+    }
+    return true;
+}
+
+std::size_t QueryRunner::RunScript(std::istream& script, std::ostream& out) {
+    std::size_t errors = 0;
+    std::string line;
+    while (getline(script, line)) {
+        if (!Run(line, out)) {
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void QueryRunner::PrintTimings(std::ostream& out) const {
+    typedef std::chrono::duration<double, std::micro> Microseconds;
+    std::size_t count = 0;
+    std::chrono::nanoseconds total{0};
+
+    out << "Query timings (microseconds):" << std::endl;
+    out << std::left << std::setw(12) << "query" << std::right << std::setw(10) << "count" << std::setw(14) << "total"
+        << std::setw(12) << "mean" << std::setw(12) << "max" << std::endl;
+    out << std::fixed << std::setprecision(1);
+    for (std::size_t kind = 0; kind < m_timings.size(); ++kind) {
+        const Timing& timing = m_timings[kind];
+        if (timing.count == 0) {
+            continue;
+        }
+        out << std::left << std::setw(12) << COMMANDS[kind] << std::right << std::setw(10) << timing.count
+            << std::setw(14) << Microseconds(timing.total).count()
+            << std::setw(12) << Microseconds(timing.total).count() / timing.count
+            << std::setw(12) << Microseconds(timing.longest).count() << std::endl;
+        count += timing.count;
+        total += timing.total;
+    }
+    out << count << " queries in " << Microseconds(total).count() << " microseconds";
+    if (m_errors > 0) {
+        out << ", " << m_errors << " invalid";
+    }
+    out << std::endl;
+    out << "Result cache: " << wd.GetCacheHits() << " hits, " << wd.GetCacheMisses() << " misses" << std::endl;
+}
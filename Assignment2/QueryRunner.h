@@ -0,0 +1,115 @@
+#ifndef QUERYRUNNER_H
+#define QUERYRUNNER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include "WeatherData.h"
+
+/**
+ * @brief Runs the queries of the menu from lines of text instead of prompts.
+ *
+ * Each query is one line: a command followed by its arguments, separated by spaces.
+ *   wind MONTH YEAR          Average wind speed and stdev of a month (menu option 1)
+ *   temperature YEAR         Average temperature and stdev of each month (menu option 2)
+ *   spcc MONTH               sPCC of a month over every year (menu option 3)
+ *   export YEAR [FILE]       Monthly summary of a year written to a CSV file (menu option 4)
+ *   hourly MONTH YEAR        Averages of each hour of the day in a month (menu option 5)
+ *   solar YEAR               Total solar radiation of each month
+ * Empty lines and lines starting with '#' are skipped. Months and years are checked with the
+ * same rules as the menu.
+ */
+class QueryRunner {
+public:
+    /**
+     * @brief The kinds of query, in the order they are listed in the timing summary.
+     */
+    enum class Kind { Wind, Temperature, Correlation, Export, Hourly, Solar, Count };
+
+    /**
+     * @brief The file export writes when no FILE is given, as the menu does.
+     */
+    static const char* const DEFAULT_EXPORT_PATH;
+
+    /**
+     * @brief A parsed query.
+     */
+    struct Query {
+        Kind kind; // The command
+        int month; // The month (1-12), for the commands that take one
+        int year; // The year, for the commands that take one
+        std::string path; // The file written by export
+    };
+
+    /**
+     * @brief Construct a runner over loaded weather data.
+     * @param wd The weather data the queries are answered from.
+     */
+    QueryRunner(WeatherData& wd);
+
+    /**
+     * @brief Parse one line of a script.
+     *
+     * @param line The line.
+     * @param query The query, set if the line holds one.
+     * @param error The reason the line is invalid, set if it is.
+     * @return true If the line holds a valid query.
+     * @return false If the line is empty, a comment or invalid (error is empty unless invalid).
+     */
+    static bool Parse(const std::string& line, Query& query, std::string& error);
+
+    /**
+     * @brief Answer a parsed query.
+     * @param query The query.
+     * @param out The stream the results are printed to.
+     */
+    void Execute(const Query& query, std::ostream& out);
+
+    /**
+     * @brief Parse and answer one line, and time the query.
+     *
+     * An invalid line prints "Invalid query: " and the reason to out and counts as an error.
+     *
+     * @param line The line.
+     * @param out The stream the results are printed to.
+     * @return true If the line was a valid query or had nothing to run.
+     * @return false If the line was invalid.
+     */
+    bool Run(const std::string& line, std::ostream& out);
+
+    /**
+     * @brief Run every line of a script in order.
+     * @param script The stream the lines are read from.
+     * @param out The stream the results are printed to.
+     * @return std::size_t The number of invalid lines.
+     */
+    std::size_t RunScript(std::istream& script, std::ostream& out);
+
+    /**
+     * @brief Print the number of queries run of each kind with their total, mean and longest time.
+     * @param out The stream the summary is printed to.
+     */
+    void PrintTimings(std::ostream& out) const;
+
+    /**
+     * @brief Get the command that names a kind of query in a script.
+     * @param kind The kind of query.
+     * @return const char* The command.
+     */
+    static const char* CommandName(Kind kind);
+
+private:
+    struct Timing {
+        std::size_t count = 0; // The number of queries run
+        std::chrono::nanoseconds total{0}; // The time spent on them
+        std::chrono::nanoseconds longest{0}; // The longest of them
+    };
+
+    WeatherData& wd; // The weather data the queries are answered from
+    std::array<Timing, static_cast<std::size_t>(Kind::Count)> m_timings; // The timing of each kind of query
+    std::size_t m_errors; // The number of invalid lines
+};
+
+#endif // QUERYRUNNER_H
@@ -0,0 +1,313 @@
+#include "QueryServer.h"
+
+#include <charconv>
+#include <chrono>
+#include <sstream>
+
+#ifndef _WIN32
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const int ACCEPT_WAIT_MS = 200; // How long the accept loop waits before checking for Stop
+const std::chrono::seconds FOLLOW_INTERVAL(1); // How often followed files are read
+
+#ifndef _WIN32
+// Connect to the socket at a path; -1 if nobody is listening there
+int Connect(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+    int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket >= 0 && connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(socket);
+        socket = -1;
+    }
+    return socket;
+}
+
+// Send every byte of a buffer; false if the peer has gone
+bool SendAll(int socket, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t count = send(socket, data.data() + sent, data.size() - sent, 0);
+        if (count <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+QueryServer::QueryServer(WeatherData& wdInput) : wd(wdInput), m_path(), m_listener(-1), m_running(false), m_dataMutex(),
+    m_exportMutex(), m_connectionsMutex(), m_connections() {}
+
+QueryServer::~QueryServer() {
+    Stop();
+    JoinConnections(true);
+#ifndef _WIN32
+    if (m_listener >= 0) {
+        close(m_listener);
+        unlink(m_path.c_str());
+    }
+#endif
+}
+
+#ifdef _WIN32
+
+bool QueryServer::Start(const std::string&) {
+    std::cout << "The query server is not supported on this platform" << std::endl;
+    return false;
+}
+
+void QueryServer::Run() {}
+
+void QueryServer::Serve(Connection&) {}
+
+void QueryServer::JoinConnections(bool) {}
+
+bool QueryServer::Ask(const std::string& path, const std::string&, std::string& reply) {
+    reply = "Cannot connect to " + path;
+    return false;
+}
+
+#else
+
+bool QueryServer::Start(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cout << "Socket path too long: " << path << std::endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+
+    // A socket file nobody accepts on was left by a server that did not stop cleanly
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        int running = Connect(path);
+        if (running >= 0) {
+            close(running);
+            std::cout << "Another server is using " << path << std::endl;
+            return false;
+        }
+        unlink(path.c_str());
+    }
+
+    m_listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listener < 0 || bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(m_listener, SOMAXCONN) != 0) {
+        std::cout << "Error creating socket: " << path << std::endl;
+        if (m_listener >= 0) {
+            close(m_listener);
+            m_listener = -1;
+        }
+        return false;
+    }
+    // A client that disconnects before its reply is sent must not end the server
+    std::signal(SIGPIPE, SIG_IGN);
+    m_path = path;
+    m_running = true;
+    return true;
+}
+
+void QueryServer::Run() {
+    auto lastPoll = std::chrono::steady_clock::now();
+    while (m_running) {
+        pollfd listener{m_listener, POLLIN, 0};
+        if (poll(&listener, 1, ACCEPT_WAIT_MS) > 0 && (listener.revents & POLLIN)) {
+            int client = accept(m_listener, nullptr, nullptr);
+            if (client >= 0) {
+                std::lock_guard<std::mutex> lock(m_connectionsMutex);
+                m_connections.push_back(Connection{client, std::thread(), false});
+                Connection& connection = m_connections.back();
+                connection.thread = std::thread(&QueryServer::Serve, this, std::ref(connection));
+            }
+        }
+
+        // Read lines appended to the followed files while no query is running
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastPoll >= FOLLOW_INTERVAL) {
+            std::unique_lock<std::shared_mutex> lock(m_dataMutex);
+            std::size_t added = wd.PollFollowedFiles();
+            if (added > 0) {
+                std::cout << "Loaded " << added << " new readings" << std::endl;
+            }
+            lastPoll = now;
+        }
+        JoinConnections(false);
+    }
+
+    // Refuse new clients, then end the connections that are still open
+    close(m_listener);
+    unlink(m_path.c_str());
+    m_listener = -1;
+    JoinConnections(true);
+}
+
+void QueryServer::Serve(Connection& connection) {
+    QueryRunner runner(wd);
+    std::string buffer;
+    char chunk[4096];
+    bool open = true;
+    while (open) {
+        std::size_t newline = buffer.find('\n');
+        if (newline == std::string::npos) {
+            if (buffer.size() > MAX_REQUEST) {
+                SendAll(connection.socket, "ERROR request too long\n");
+                break;
+            }
+            ssize_t count = recv(connection.socket, chunk, sizeof(chunk), 0);
+            if (count <= 0) {
+                break;
+            }
+            buffer.append(chunk, static_cast<std::size_t>(count));
+            continue;
+        }
+
+        std::string line = buffer.substr(0, newline);
+        buffer.erase(0, newline + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        std::string reply;
+        open = Answer(line, runner, reply);
+        if (!reply.empty() && !SendAll(connection.socket, reply)) {
+            break;
+        }
+    }
+
+    // The socket is closed when the thread is joined, so it cannot be reused while still listed
+    std::lock_guard<std::mutex> lock(m_connectionsMutex);
+    connection.done = true;
+}
+
+void QueryServer::JoinConnections(bool all) {
+    std::list<Connection> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        for (auto connection = m_connections.begin(); connection != m_connections.end();) {
+            if (all && !connection->done) {
+                // Wake the thread from recv; it sees the connection closed and returns
+                shutdown(connection->socket, SHUT_RDWR);
+            }
+            if (all || connection->done) {
+                finished.splice(finished.end(), m_connections, connection++);
+            } else {
+                ++connection;
+            }
+        }
+    }
+    for (Connection& connection : finished) {
+        connection.thread.join();
+        close(connection.socket);
+    }
+}
+
+bool QueryServer::Ask(const std::string& path, const std::string& request, std::string& reply) {
+    int socket = Connect(path);
+    if (socket < 0) {
+        reply = "Cannot connect to " + path;
+        return false;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::string received;
+    char chunk[4096];
+    bool ok = false;
+    bool answered = false;
+    if (SendAll(socket, request + "\n")) {
+        ssize_t count;
+        while (!answered && (count = recv(socket, chunk, sizeof(chunk), 0)) > 0) {
+            received.append(chunk, static_cast<std::size_t>(count));
+            std::size_t newline = received.find('\n');
+            if (newline == std::string::npos) {
+                continue;
+            }
+            // "OK n" is followed by n bytes of text; "ERROR reason" is the whole answer
+            if (received.compare(0, 3, "OK ") == 0) {
+                const char* lengthEnd = received.data() + newline;
+                std::size_t length = 0;
+                std::from_chars_result parsed = std::from_chars(received.data() + 3, lengthEnd, length);
+                if (parsed.ec != std::errc() || parsed.ptr != lengthEnd) {
+                    reply = "Bad reply from " + path;
+                    answered = true;
+                } else if (received.size() - newline - 1 >= length) {
+                    reply = received.substr(newline + 1, length);
+                    ok = true;
+                    answered = true;
+                }
+            } else {
+                std::size_t start = received.compare(0, 6, "ERROR ") == 0 ? 6 : 0;
+                reply = received.substr(start, newline - start);
+                answered = true;
+            }
+        }
+    }
+    close(socket);
+    if (!answered) {
+        reply = "No answer from " + path;
+    }
+    return ok;
+}
+
+#endif
+
+void QueryServer::Stop() {
+    m_running = false;
+}
+
+bool QueryServer::Answer(const std::string& line, QueryRunner& runner, std::string& reply) {
+    std::istringstream words(line);
+    std::string command;
+    words >> command;
+    if (command == "quit") {
+        return false;
+    }
+    if (command == "shutdown") {
+        Stop();
+        reply = "OK 0\n";
+        return false;
+    }
+
+    std::ostringstream text;
+    if (command == "stats") {
+        text << "Result cache: " << wd.GetCacheHits() << " hits, " << wd.GetCacheMisses() << " misses" << std::endl;
+    } else {
+        QueryRunner::Query query;
+        std::string error;
+        if (!QueryRunner::Parse(line, query, error)) {
+            if (!error.empty()) {
+                reply = "ERROR " + error + "\n";
+                return true;
+            }
+        } else if (query.kind == QueryRunner::Kind::Export) {
+            // A client may not choose the file the server writes
+            if (query.path != QueryRunner::DEFAULT_EXPORT_PATH) {
+                reply = "ERROR export cannot choose a file here, it writes " + std::string(QueryRunner::DEFAULT_EXPORT_PATH) + "\n";
+                return true;
+            }
+            // Exports only read the data, but write the same file, so two of them never run at once
+            std::shared_lock<std::shared_mutex> lock(m_dataMutex);
+            std::lock_guard<std::mutex> exportLock(m_exportMutex);
+            runner.Execute(query, text);
+        } else {
+            std::shared_lock<std::shared_mutex> lock(m_dataMutex);
+            runner.Execute(query, text);
+        }
+    }
+    reply = "OK " + std::to_string(text.str().size()) + "\n" + text.str();
+    return true;
+}
@@ -0,0 +1,133 @@
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include "QueryRunner.h"
+#include "WeatherData.h"
+
+/**
+ * @brief Answers the queries of the menu for local clients over a Unix domain socket.
+ *
+ * The data is loaded once by the caller and stays resident while the server runs. Each client
+ * connection is served on its own thread, so several clients are answered at the same time.
+ *
+ * The protocol is line based. A client sends one request per line:
+ *   a query, in the syntax of QueryRunner (e.g. "wind 1 2007" or "spcc 3"), except that
+ *     export always writes QueryRunner::DEFAULT_EXPORT_PATH and refuses a FILE argument,
+ *   "stats" for the number of result cache hits and misses,
+ *   "quit" to close the connection, or
+ *   "shutdown" to stop the server.
+ * Each request is answered with "OK n" and a newline, followed by exactly n bytes of result
+ * text, or with one line "ERROR reason". The lines of a result are those the menu prints.
+ *
+ * Lines appended to followed files are picked up about once a second. Queries share the data,
+ * while an update holds it alone, so a result never mixes old and new readings. Exports also
+ * take a lock of their own, so only one writes its file at a time.
+ *
+ * Only POSIX systems are supported; on Windows Start reports an error.
+ */
+class QueryServer {
+public:
+    /**
+     * @brief The longest request line accepted, in bytes.
+     */
+    static const std::size_t MAX_REQUEST = 4096;
+
+    /**
+     * @brief Construct a server over loaded weather data.
+     * @param wd The weather data the queries are answered from.
+     */
+    QueryServer(WeatherData& wd);
+
+    /**
+     * @brief Stop the server and remove its socket.
+     */
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * @brief Create the socket and start listening.
+     *
+     * A socket file left behind by a server that is no longer running is replaced.
+     *
+     * @param path The path of the socket file.
+     * @return true If the socket is listening.
+     * @return false If it cannot be created, for example because another server is using the path.
+     */
+    bool Start(const std::string& path);
+
+    /**
+     * @brief Accept and serve clients until Stop is called or a client sends "shutdown".
+     *
+     * Returns once every client connection has been closed.
+     */
+    void Run();
+
+    /**
+     * @brief Ask a running Run to return. May be called from any thread.
+     */
+    void Stop();
+
+    /**
+     * @brief Send one request to a server and read its answer.
+     *
+     * @param path The path of the server's socket file.
+     * @param request The request line, without the newline.
+     * @param reply Receives the result text, or the reason of an error.
+     * @return true If the server answered OK.
+     * @return false If the server answered with an error or cannot be reached.
+     */
+    static bool Ask(const std::string& path, const std::string& request, std::string& reply);
+
+private:
+    WeatherData& wd; // The weather data the queries are answered from
+    std::string m_path; // The path of the socket file (empty until Start succeeds)
+    int m_listener; // The listening socket, or -1
+    std::atomic<bool> m_running; // False once the server has been asked to stop
+    std::shared_mutex m_dataMutex; // Held shared by queries and exclusively while followed files are read
+    std::mutex m_exportMutex; // Held by an export while it writes its file
+
+    /**
+     * @brief A client connection and the thread that serves it.
+     */
+    struct Connection {
+        int socket; // The connected socket
+        std::thread thread; // The thread reading its requests
+        bool done; // True once the client has disconnected and the thread can be joined
+    };
+
+    std::mutex m_connectionsMutex; // Guards m_connections
+    std::list<Connection> m_connections; // The connections whose threads have not been joined
+
+    /**
+     * @brief Read the requests of one client and answer them until it disconnects.
+     * @param connection The connection of the client.
+     */
+    void Serve(Connection& connection);
+
+    /**
+     * @brief Join the threads of the clients that have disconnected.
+     * @param all True to close every connection first and join every thread.
+     */
+    void JoinConnections(bool all);
+
+    /**
+     * @brief Answer one request.
+     *
+     * @param line The request line.
+     * @param runner The query runner of the connection.
+     * @param reply Receives the framed reply.
+     * @return true If the connection stays open after the reply.
+     */
+    bool Answer(const std::string& line, QueryRunner& runner, std::string& reply);
+};
+
+#endif // QUERYSERVER_H
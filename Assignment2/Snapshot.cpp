@@ -0,0 +1,254 @@
+#include "Snapshot.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace {
+
+const char MAGIC[8] = {'W', 'X', 'S', 'N', 'A', 'P', '\0', '\0'};
+const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+const std::size_t BUFFER_VALUES = 8192; // The values widened per write from a compact column
+
+// Round a byte count up to the next multiple of 8 so every column starts aligned
+std::size_t Padded(std::size_t bytes) {
+    return (bytes + 7) & ~static_cast<std::size_t>(7);
+}
+
+const std::uint64_t HASH_OFFSET = 14695981039346656037ull;
+const std::uint64_t HASH_PRIME = 1099511628211ull;
+
+// Mix one 8-byte word into a hash
+std::uint64_t MixWord(std::uint64_t hash, const char* data) {
+    std::uint64_t word;
+    std::memcpy(&word, data, 8);
+    return (hash ^ word) * HASH_PRIME;
+}
+
+// Read the size and modification time of a file without opening it
+bool StatFile(const std::string& filename, std::uint64_t& size, std::int64_t& modified) {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0) {
+        return false;
+    }
+    size = static_cast<std::uint64_t>(info.st_size);
+    modified = static_cast<std::int64_t>(info.st_mtime);
+    return true;
+}
+
+template <class T>
+void Put(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void PutPadding(std::ostream& out, std::size_t bytes) {
+    static const char zeros[8] = {};
+    out.write(zeros, static_cast<std::streamsize>(Padded(bytes) - bytes));
+}
+
+// Reads fields from the mapped snapshot, failing instead of reading past the end
+class Reader {
+private:
+    const char* m_cursor;
+    const char* m_end;
+
+public:
+    Reader(const char* data, std::size_t size) : m_cursor(data), m_end(data + size) {}
+
+    // Return the next bytes and step over them (and their padding), or nullptr if the file is too short
+    const char* Take(std::size_t bytes) {
+        if (static_cast<std::size_t>(m_end - m_cursor) < Padded(bytes)) {
+            return nullptr;
+        }
+        const char* taken = m_cursor;
+        m_cursor += Padded(bytes);
+        return taken;
+    }
+
+    template <class T>
+    bool Get(T& value) {
+        if (static_cast<std::size_t>(m_end - m_cursor) < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return true;
+    }
+};
+
+} // namespace
+
+SourceHasher::SourceHasher() : m_hash(HASH_OFFSET), m_size(0), m_pending() {}
+
+void SourceHasher::Update(const char* data, std::size_t size) {
+    std::size_t pending = static_cast<std::size_t>(m_size % 8);
+    m_size += size;
+    // Finish the word an earlier piece started
+    if (pending > 0) {
+        std::size_t taken = std::min(size, 8 - pending);
+        std::memcpy(m_pending + pending, data, taken);
+        data += taken;
+        size -= taken;
+        if (pending + taken < 8) {
+            return;
+        }
+        m_hash = MixWord(m_hash, m_pending);
+    }
+    for (; size >= 8; data += 8, size -= 8) {
+        m_hash = MixWord(m_hash, data);
+    }
+    std::memcpy(m_pending, data, size);
+}
+
+std::uint64_t SourceHasher::Value() const {
+    std::uint64_t hash = m_hash;
+    for (std::size_t i = 0; i < m_size % 8; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(m_pending[i])) * HASH_PRIME;
+    }
+    return hash;
+}
+
+bool Snapshot::Stamp(const std::string& filename, SourceStamp& stamp) {
+    MappedFile file;
+    if (!StatFile(filename, stamp.m_size, stamp.m_modified) || !file.Open(filename)) {
+        return false;
+    }
+    SourceHasher hasher;
+    hasher.Update(file.Data(), file.Size());
+    stamp.m_path = filename;
+    stamp.m_hash = hasher.Value();
+    return true;
+}
+
+bool Snapshot::Write(const std::string& path, const std::vector<SourceStamp>& sources, unsigned sensorColumns,
+                     DuplicatePolicy duplicates, const std::map<int, YearColumns>& data) {
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    const std::uint32_t reserved = 0;
+    out.write(MAGIC, sizeof(MAGIC));
+    Put(out, VERSION);
+    Put(out, BYTE_ORDER_MARK);
+    Put(out, static_cast<std::uint32_t>(sensorColumns));
+    Put(out, static_cast<std::uint32_t>(sources.size()));
+    Put(out, static_cast<std::uint32_t>(data.size()));
+    Put(out, static_cast<std::uint32_t>(duplicates));
+
+    for (const SourceStamp& stamp : sources) {
+        Put(out, static_cast<std::uint32_t>(stamp.m_path.size()));
+        Put(out, reserved);
+        Put(out, stamp.m_size);
+        Put(out, stamp.m_modified);
+        Put(out, stamp.m_hash);
+        out.write(stamp.m_path.data(), static_cast<std::streamsize>(stamp.m_path.size()));
+        PutPadding(out, stamp.m_path.size());
+    }
+
+    for (const auto& yearDataPair : data) {
+        const YearColumns& columns = yearDataPair.second;
+        Put(out, static_cast<std::int32_t>(yearDataPair.first));
+        Put(out, reserved);
+        Put(out, static_cast<std::uint64_t>(columns.Size()));
+        out.write(reinterpret_cast<const char*>(columns.Timestamps().data()), static_cast<std::streamsize>(columns.Size() * sizeof(Timestamp)));
+        PutPadding(out, columns.Size() * sizeof(Timestamp));
+        // Compact columns are widened a block at a time, so the file holds doubles whatever the storage
+        std::vector<double> buffer(BUFFER_VALUES);
+        for (Metric metric : {Metric::WindSpeed, Metric::Temperature, Metric::SolarRadiation}) {
+            ColumnSpan column = columns.Column(metric);
+            if (column.Doubles() != nullptr) {
+                out.write(reinterpret_cast<const char*>(column.Doubles()), static_cast<std::streamsize>(columns.Size() * sizeof(double)));
+                continue;
+            }
+            for (std::size_t first = 0; first < column.size(); first += buffer.size()) {
+                std::size_t count = std::min(buffer.size(), column.size() - first);
+                column.Read(first, count, buffer.data());
+                out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(count * sizeof(double)));
+            }
+        }
+    }
+
+    out.close();
+    if (!out) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+
+    // rename does not replace an existing file on Windows
+    std::remove(path.c_str());
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+bool Snapshot::Read(const std::string& path, const std::vector<std::string>& sources, unsigned sensorColumns,
+                    DuplicatePolicy duplicates, std::map<int, YearColumns>& target, std::vector<SourceStamp>& stamps) {
+    MappedFile file;
+    if (!file.Open(path)) {
+        return false;
+    }
+    Reader reader(file.Data(), file.Size());
+
+    const char* magic = reader.Take(sizeof(MAGIC));
+    std::uint32_t version, byteOrder, savedColumns, sourceCount, yearCount, savedDuplicates, reserved;
+    if (magic == nullptr || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !reader.Get(version) || !reader.Get(byteOrder)
+        || !reader.Get(savedColumns) || !reader.Get(sourceCount) || !reader.Get(yearCount) || !reader.Get(savedDuplicates)) {
+        return false;
+    }
+    if (version != VERSION || byteOrder != BYTE_ORDER_MARK || savedColumns != sensorColumns
+        || savedDuplicates != static_cast<std::uint32_t>(duplicates) || sourceCount != sources.size()) {
+        return false;
+    }
+
+    // Check the cheap size and time first and only hash a file that still looks the same
+    std::vector<SourceStamp> accepted;
+    for (const std::string& source : sources) {
+        std::uint32_t pathLength;
+        SourceStamp saved;
+        if (!reader.Get(pathLength) || !reader.Get(reserved) || !reader.Get(saved.m_size) || !reader.Get(saved.m_modified)
+            || !reader.Get(saved.m_hash)) {
+            return false;
+        }
+        const char* savedPath = reader.Take(pathLength);
+        if (savedPath == nullptr || source != std::string(savedPath, pathLength)) {
+            return false;
+        }
+
+        SourceStamp current;
+        if (!StatFile(source, current.m_size, current.m_modified) || current.m_size != saved.m_size
+            || current.m_modified != saved.m_modified || !Stamp(source, current) || current.m_hash != saved.m_hash) {
+            return false;
+        }
+        saved.m_path = source;
+        accepted.push_back(saved);
+    }
+
+    std::map<int, YearColumns> years;
+    for (std::uint32_t y = 0; y < yearCount; ++y) {
+        std::int32_t year;
+        std::uint64_t rows;
+        if (!reader.Get(year) || !reader.Get(reserved) || !reader.Get(rows) || rows > file.Size()) {
+            return false;
+        }
+        const char* timestamps = reader.Take(rows * sizeof(Timestamp));
+        const char* windSpeed = reader.Take(rows * sizeof(double));
+        const char* temperature = reader.Take(rows * sizeof(double));
+        const char* solarRadiation = reader.Take(rows * sizeof(double));
+        if (timestamps == nullptr || windSpeed == nullptr || temperature == nullptr || solarRadiation == nullptr) {
+            return false;
+        }
+        // Every column starts on an 8-byte boundary of the page-aligned mapping
+        years[year].Assign(reinterpret_cast<const Timestamp*>(timestamps), reinterpret_cast<const double*>(windSpeed),
+                           reinterpret_cast<const double*>(temperature), reinterpret_cast<const double*>(solarRadiation),
+                           static_cast<std::size_t>(rows));
+    }
+
+    for (auto& yearDataPair : years) {
+        target[yearDataPair.first] = std::move(yearDataPair.second);
+    }
+    stamps = std::move(accepted);
+    return true;
+}
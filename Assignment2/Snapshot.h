@@ -0,0 +1,126 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "YearColumns.h"
+
+/**
+ * @brief The identity of a source file, taken from the bytes the loader parsed.
+ */
+struct SourceStamp {
+    std::string m_path; // The name of the file as it was given to the loader
+    std::uint64_t m_size; // The number of bytes of the file that were parsed
+    std::int64_t m_modified; // The last modification time of the file in seconds since 1970
+    std::uint64_t m_hash; // The SourceHasher hash of the bytes that were parsed
+};
+
+/**
+ * @brief Hashes the bytes of a source file piece by piece as they are parsed.
+ *
+ * The hash is a word-wise variant of FNV-1a: it mixes in eight bytes per step and the last
+ * few bytes one at a time. Pieces of any length give the same hash as the whole file at once.
+ */
+class SourceHasher {
+private:
+    std::uint64_t m_hash; // The hash of the whole words fed so far
+    std::uint64_t m_size; // The number of bytes fed so far
+    char m_pending[8]; // The bytes fed since the last whole word
+
+public:
+    /**
+     * @brief Construct a new SourceHasher object that has been fed no bytes.
+     */
+    SourceHasher();
+
+    /**
+     * @brief Feed the next bytes of the file.
+     *
+     * @param data The first byte.
+     * @param size The number of bytes.
+     */
+    void Update(const char* data, std::size_t size);
+
+    /**
+     * @brief Get the number of bytes fed so far.
+     * @return std::uint64_t The number of bytes.
+     */
+    std::uint64_t Size() const { return m_size; }
+
+    /**
+     * @brief Get the hash of the bytes fed so far.
+     * @return std::uint64_t The hash.
+     */
+    std::uint64_t Value() const;
+};
+
+/**
+ * @brief A versioned binary copy of the loaded data that can be read back without parsing.
+ *
+ * A snapshot holds the columns of every year as doubles, plus a stamp of each source CSV
+ * file that covers exactly the bytes the data was parsed from. Compact columns are widened when written, so the same snapshot serves both storage
+ * modes. Reading maps the snapshot into memory and copies the
+ * columns straight into YearColumns, so no text is converted. A snapshot is only accepted
+ * if it has the current version, was loaded with the same sensor columns and duplicate policy, and lists the
+ * same source files in the same order, each with the same size, modification time and
+ * content hash. The hash is only computed when the size and time already match. A file that
+ * has grown since it was parsed, even by an incomplete last line, no longer matches.
+ *
+ * The layout is native-endian and is rejected on a machine of the other byte order:
+ *   header:  magic "WXSNAP\0\0", u32 version, u32 byte order mark, u32 sensor columns,
+ *            u32 source count, u32 year count, u32 duplicate policy
+ *   source:  u32 path length, u32 reserved, u64 size, i64 modified, u64 hash, path padded to 8 bytes
+ *   year:    i32 year, u32 reserved, u64 rows, timestamps padded to 8 bytes,
+ *            then the wind speed, temperature and solar radiation columns
+ */
+class Snapshot {
+public:
+    /**
+     * @brief The version written into new snapshots. Older or newer versions are rejected.
+     */
+    static constexpr std::uint32_t VERSION = 2;
+
+    /**
+     * @brief Stamp a source file with its size, modification time and content hash.
+     *
+     * @param filename The name of the file.
+     * @param stamp The stamp to be filled in.
+     * @return true If the file exists and can be read.
+     */
+    static bool Stamp(const std::string& filename, SourceStamp& stamp);
+
+    /**
+     * @brief Write a snapshot of loaded data.
+     *
+     * The file is written under a temporary name and renamed when complete, so a reader
+     * never sees a partial snapshot.
+     *
+     * @param path The name of the snapshot file.
+     * @param sources The stamps of the files the data was loaded from, in load order.
+     * @param sensorColumns The SensorColumn flags the data was loaded with.
+     * @param duplicates The duplicate policy the data was loaded with.
+     * @param data The loaded data.
+     * @return true If the snapshot is successfully written.
+     */
+    static bool Write(const std::string& path, const std::vector<SourceStamp>& sources, unsigned sensorColumns,
+                      DuplicatePolicy duplicates, const std::map<int, YearColumns>& data);
+
+    /**
+     * @brief Read a snapshot if it is still valid for the given source files.
+     *
+     * @param path The name of the snapshot file.
+     * @param sources The files the data would be loaded from, in load order.
+     * @param sensorColumns The SensorColumn flags the data would be loaded with.
+     * @param duplicates The duplicate policy the data would be loaded with.
+     * @param target The map that receives the rows of every year. It is left unchanged if the snapshot is rejected.
+     * @param stamps Receives the stamps of the sources, in load order, if the snapshot is accepted.
+     * @return true If the snapshot exists, matches the sources and is read completely.
+     */
+    static bool Read(const std::string& path, const std::vector<std::string>& sources, unsigned sensorColumns,
+                     DuplicatePolicy duplicates, std::map<int, YearColumns>& target, std::vector<SourceStamp>& stamps);
+};
+
+#endif // SNAPSHOT_H
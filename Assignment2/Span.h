@@ -0,0 +1,56 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A non-owning view of a contiguous array, like std::span in C++20.
+ *
+ * The view holds a pointer and a length only, so it is cheap to pass by value. The array
+ * must outlive the view.
+ *
+ * @tparam T The element type (use a const type for a read-only view).
+ */
+template <class T>
+class Span {
+private:
+    T* m_data; // The first element of the view
+    std::size_t m_size; // The number of elements in the view
+
+public:
+    /**
+     * @brief Construct an empty view.
+     */
+    Span() : m_data(nullptr), m_size(0) {}
+
+    /**
+     * @brief Construct a view of count elements starting at data.
+     */
+    Span(T* data, std::size_t count) : m_data(data), m_size(count) {}
+
+    /**
+     * @brief Construct a view of every element of a vector.
+     */
+    template <class U, class = typename std::enable_if<std::is_same<typename std::remove_const<T>::type, U>::value>::type>
+    Span(const std::vector<U>& values) : m_data(values.data()), m_size(values.size()) {}
+
+    T* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+    T& operator[](std::size_t index) const { return m_data[index]; }
+
+    /**
+     * @brief Get a view of part of this view.
+     *
+     * @param offset The index of the first element of the part.
+     * @param count The number of elements in the part.
+     * @return Span The view of elements [offset, offset + count).
+     */
+    Span Subspan(std::size_t offset, std::size_t count) const { return Span(m_data + offset, count); }
+};
+
+#endif // SPAN_H
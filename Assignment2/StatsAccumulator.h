@@ -0,0 +1,293 @@
+#ifndef STATSACCUMULATOR_H
+#define STATSACCUMULATOR_H
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "Kernels.h"
+#include "Metric.h"
+#include "MetricColumn.h"
+#include "Span.h"
+
+/**
+ * @brief A single-pass, mergeable accumulator of statistics over N variables.
+ *
+ * Each call to Add updates the count, total, minimum, maximum, running mean and the sum
+ * of squared deviations of every variable, and the co-moment of every pair of variables
+ * (Welford's method). Two accumulators built over different chunks of data, for example
+ * on different threads, are combined with Merge (Chan's formula). Deviations are always
+ * taken from the running mean, so variances and covariances stay accurate even when the
+ * mean is large compared to the spread, unlike the E[x^2] - E[x]^2 form.
+ *
+ * @tparam N The number of variables observed together.
+ */
+template <int N>
+class StatsAccumulator {
+private:
+    std::size_t m_count; // The number of observations
+    double m_total[N]; // The sum of each variable
+    double m_mean[N]; // The running mean of each variable
+    double m_m2[N]; // The sum of squared deviations from the mean of each variable
+    double m_min[N]; // The smallest value of each variable
+    double m_max[N]; // The largest value of each variable
+    double m_comoment[N][N]; // The sum of products of deviations of each pair (i < j)
+
+    static const std::size_t BLOCK_ROWS = 4096; // The rows per block when adding whole columns
+
+public:
+    /**
+     * @brief Construct an empty accumulator.
+     */
+    StatsAccumulator() : m_count(0), m_total(), m_mean(), m_m2(), m_min(), m_max(), m_comoment() {
+        for (int i = 0; i < N; ++i) {
+            m_min[i] = std::numeric_limits<double>::infinity();
+            m_max[i] = -std::numeric_limits<double>::infinity();
+        }
+    }
+
+    /**
+     * @brief Add one observation.
+     * @param values The value of each of the N variables.
+     */
+    void Add(const double (&values)[N]) {
+        m_count++;
+        const double n = static_cast<double>(m_count);
+        double before[N]; // The deviations from the old means
+        for (int i = 0; i < N; ++i) {
+            before[i] = values[i] - m_mean[i];
+            m_mean[i] += before[i] / n;
+            m_m2[i] += before[i] * (values[i] - m_mean[i]);
+            m_total[i] += values[i];
+            m_min[i] = values[i] < m_min[i] ? values[i] : m_min[i];
+            m_max[i] = values[i] > m_max[i] ? values[i] : m_max[i];
+        }
+        for (int i = 0; i < N; ++i) {
+            for (int j = i + 1; j < N; ++j) {
+                m_comoment[i][j] += before[i] * (values[j] - m_mean[j]);
+            }
+        }
+    }
+
+    /**
+     * @brief Add one observation of a single variable.
+     * @param value The value.
+     */
+    void Add(double value) {
+        static_assert(N == 1, "Add(double) is only available for one variable");
+        const double values[1] = {value};
+        Add(values);
+    }
+
+    /**
+     * @brief Add a run of observations given as one array per variable.
+     *
+     * The run is split into blocks that stay in cache. The moments of each block are
+     * computed with the vector kernels (see Kernels.h), first the sums, then the squared
+     * deviations and co-moments about the block means, and each block is merged in with
+     * Merge. The result matches adding the rows one by one within KERNEL_TOLERANCE.
+     *
+     * @param columns The values of each variable, all of the same length.
+     */
+    void Add(const Span<const double> (&columns)[N]) {
+        const std::size_t rows = columns[0].size();
+        for (std::size_t first = 0; first < rows; first += BLOCK_ROWS) {
+            const std::size_t count = rows - first < BLOCK_ROWS ? rows - first : BLOCK_ROWS;
+            const double* values[N];
+            StatsAccumulator block;
+            block.m_count = count;
+            for (int i = 0; i < N; ++i) {
+                values[i] = columns[i].data() + first;
+                block.m_total[i] = Kernels::Sum(values[i], count);
+                block.m_mean[i] = block.m_total[i] / count;
+                block.m_m2[i] = Kernels::SumSquares(values[i], count, block.m_mean[i]);
+                block.m_min[i] = Kernels::Min(values[i], count);
+                block.m_max[i] = Kernels::Max(values[i], count);
+            }
+            for (int i = 0; i < N; ++i) {
+                for (int j = i + 1; j < N; ++j) {
+                    block.m_comoment[i][j] = Kernels::SumProducts(values[i], values[j], count, block.m_mean[i], block.m_mean[j]);
+                }
+            }
+            Merge(block);
+        }
+    }
+
+    /**
+     * @brief Add every value of an array of a single variable.
+     * @param values The values.
+     */
+    void Add(Span<const double> values) {
+        static_assert(N == 1, "Add(Span) is only available for one variable");
+        const Span<const double> columns[1] = {values};
+        Add(columns);
+    }
+
+    /**
+     * @brief Add a run of observations given as one column view per variable.
+     *
+     * Columns that hold doubles are read in place. Fixed-point columns are widened one
+     * block at a time into a buffer, so the kernels always run over arrays of doubles.
+     *
+     * @param columns The values of each variable, all of the same length.
+     */
+    void Add(const ColumnSpan (&columns)[N]) {
+        const std::size_t rows = columns[0].size();
+        std::vector<double> buffer;
+        for (std::size_t first = 0; first < rows; first += BLOCK_ROWS) {
+            const std::size_t count = rows - first < BLOCK_ROWS ? rows - first : BLOCK_ROWS;
+            Span<const double> block[N];
+            for (int i = 0; i < N; ++i) {
+                const double* values = columns[i].Doubles();
+                if (values == nullptr) {
+                    buffer.resize(N * BLOCK_ROWS);
+                    columns[i].Read(first, count, buffer.data() + i * BLOCK_ROWS);
+                    block[i] = Span<const double>(buffer.data() + i * BLOCK_ROWS, count);
+                } else {
+                    block[i] = Span<const double>(values + first, count);
+                }
+            }
+            Add(block);
+        }
+    }
+
+    /**
+     * @brief Add every value of a column view of a single variable.
+     * @param values The values.
+     */
+    void Add(ColumnSpan values) {
+        static_assert(N == 1, "Add(ColumnSpan) is only available for one variable");
+        const ColumnSpan columns[1] = {values};
+        Add(columns);
+    }
+
+    /**
+     * @brief Add every observation of another accumulator.
+     * @param other The accumulator to be merged into this one.
+     */
+    void Merge(const StatsAccumulator& other) {
+        if (other.m_count == 0) {
+            return;
+        }
+        if (m_count == 0) {
+            *this = other;
+            return;
+        }
+
+        const double countA = static_cast<double>(m_count);
+        const double countB = static_cast<double>(other.m_count);
+        const double n = countA + countB;
+        double delta[N]; // The difference between the two means
+        for (int i = 0; i < N; ++i) {
+            delta[i] = other.m_mean[i] - m_mean[i];
+        }
+        for (int i = 0; i < N; ++i) {
+            for (int j = i + 1; j < N; ++j) {
+                m_comoment[i][j] += other.m_comoment[i][j] + delta[i] * delta[j] * countA * countB / n;
+            }
+        }
+        for (int i = 0; i < N; ++i) {
+            m_m2[i] += other.m_m2[i] + delta[i] * delta[i] * countA * countB / n;
+            m_mean[i] += delta[i] * countB / n;
+            m_total[i] += other.m_total[i];
+            m_min[i] = other.m_min[i] < m_min[i] ? other.m_min[i] : m_min[i];
+            m_max[i] = other.m_max[i] > m_max[i] ? other.m_max[i] : m_max[i];
+        }
+        m_count += other.m_count;
+    }
+
+    /**
+     * @brief Get the number of observations.
+     * @return std::size_t The count.
+     */
+    std::size_t Count() const { return m_count; }
+
+    /**
+     * @brief Get the total of a variable.
+     * @param i The index of the variable.
+     * @return double The sum of the values.
+     */
+    double Total(int i = 0) const { return m_total[i]; }
+
+    /**
+     * @brief Get the mean of a variable.
+     * @param i The index of the variable.
+     * @return double The average of the values, NaN if there are none.
+     */
+    double Mean(int i = 0) const { return m_count == 0 ? std::nan("") : m_mean[i]; }
+
+    /**
+     * @brief Get the smallest value of a variable.
+     * @param i The index of the variable.
+     * @return double The minimum, +infinity if there are no values.
+     */
+    double Min(int i = 0) const { return m_min[i]; }
+
+    /**
+     * @brief Get the largest value of a variable.
+     * @param i The index of the variable.
+     * @return double The maximum, -infinity if there are no values.
+     */
+    double Max(int i = 0) const { return m_max[i]; }
+
+    /**
+     * @brief Get the population variance of a variable (divided by n).
+     * @param i The index of the variable.
+     * @return double The variance.
+     */
+    double Variance(int i = 0) const { return m_m2[i] / m_count; }
+
+    /**
+     * @brief Get the sample variance of a variable (divided by n - 1).
+     * @param i The index of the variable.
+     * @return double The variance.
+     */
+    double SampleVariance(int i = 0) const { return m_m2[i] / (m_count - 1); }
+
+    /**
+     * @brief Get the population covariance of two variables.
+     *
+     * @param i The index of the first variable.
+     * @param j The index of the second variable.
+     * @return double The covariance.
+     */
+    double Covariance(int i, int j) const {
+        if (i == j) {
+            return Variance(i);
+        }
+        return (i < j ? m_comoment[i][j] : m_comoment[j][i]) / m_count;
+    }
+
+    /**
+     * @brief Get the Pearson correlation coefficient of two variables.
+     *
+     * @param i The index of the first variable.
+     * @param j The index of the second variable.
+     * @return double The correlation coefficient.
+     */
+    double Correlation(int i, int j) const {
+        return Covariance(i, j) / std::sqrt(Variance(i) * Variance(j));
+    }
+
+    // The same statistics addressed by Metric, for accumulators over the three sensors
+    double Total(Metric metric) const { return Total(static_cast<int>(metric)); }
+    double Mean(Metric metric) const { return Mean(static_cast<int>(metric)); }
+    double Min(Metric metric) const { return Min(static_cast<int>(metric)); }
+    double Max(Metric metric) const { return Max(static_cast<int>(metric)); }
+    double Variance(Metric metric) const { return Variance(static_cast<int>(metric)); }
+    double SampleVariance(Metric metric) const { return SampleVariance(static_cast<int>(metric)); }
+    double Covariance(Metric a, Metric b) const { return Covariance(static_cast<int>(a), static_cast<int>(b)); }
+    double Correlation(Metric a, Metric b) const { return Correlation(static_cast<int>(a), static_cast<int>(b)); }
+};
+
+/**
+ * @brief The statistics of one variable.
+ */
+typedef StatsAccumulator<1> RunningStats;
+
+/**
+ * @brief The statistics of the readings of one month over wind speed, temperature and solar radiation.
+ */
+typedef StatsAccumulator<METRIC_COUNT> MonthAggregate;
+
+#endif // STATSACCUMULATOR_H
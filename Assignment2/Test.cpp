@@ -10,6 +10,24 @@ void Test::RunAllTests() {
     TestDisplayDataForYear();
     TestIsYearValid();
     TestCalculateSPCC();
+    TestLoadModes();
+    TestLoadFiles();
+    TestStatsAccumulator();
+    TestKernels();
+    TestSnapshot();
+    TestFollow();
+    TestDuplicates();
+    TestCompact();
+    TestDiurnal();
+    TestBst();
+    TestTimeIndex();
+    TestBstBulk();
+    TestBatch();
+    TestCache();
+    TestServer();
+    TestExportYears();
+    TestOutputBuffer();
+    TestExportSink();
 }
 
 void Test::TestLoadData() {
@@ -120,4 +138,528 @@ void Test::TestCalculateSPCC() {
     std::cout << "TestCalculateSPCC - Test 1: Manual verification required" << std::endl;
 }
 
+void Test::TestLoadModes() {
+    // Test that the mapped loader produces the same data as the stream loader
+    DataProcessor streamLoader;
+    streamLoader.SetLoadMode(LoadMode::Stream);
+    streamLoader.LoadData("data/Metdata-Jan-Dec2007.csv");
 
+    DataProcessor mappedLoader;
+    mappedLoader.SetLoadMode(LoadMode::Mapped);
+    mappedLoader.LoadData("data/Metdata-Jan-Dec2007.csv");
+
+    bool same = streamLoader.GetYears() == mappedLoader.GetYears();
+    for (int year : streamLoader.GetYears()) {
+        ReadingsView expected = streamLoader.SelectYear(year);
+        ReadingsView actual = mappedLoader.SelectYear(year);
+        same = same && expected.size() == actual.size();
+        for (std::size_t i = 0; same && i < expected.size(); ++i) {
+            same = expected.Timestamps()[i] == actual.Timestamps()[i] && expected.WindSpeed()[i] == actual.WindSpeed()[i]
+                   && expected.Temperature()[i] == actual.Temperature()[i]
+                   && expected.SolarRadiation()[i] == actual.SolarRadiation()[i];
+        }
+    }
+    std::cout << "TestLoadModes - Test 1: " << (same ? "Pass" : "Fail") << std::endl;
+
+    // Test that a missing file is reported in mapped mode
+    bool result2 = mappedLoader.LoadData("data/non_existent_file.csv");
+    std::cout << "TestLoadModes - Test 2: " << (!result2 ? "Pass" : "Fail") << std::endl;
+
+    // Test that unselected sensor columns are skipped and read as 0.0
+    DataProcessor windLoader;
+    windLoader.SetSensorColumns(SENSOR_WIND_SPEED);
+    windLoader.LoadData("data/Metdata-Jan-Dec2007.csv");
+    ReadingsView january = windLoader.Search(1, 2007);
+    bool projected = !january.empty();
+    for (const MonthData monthData : january) {
+        projected = projected && monthData.m_temperature == 0.0 && monthData.m_solarRadiation == 0.0;
+    }
+    std::cout << "TestLoadModes - Test 3: " << (projected ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestLoadFiles() {
+    std::vector<std::string> filenames = {"data/MetData-31-3b.csv", "data/Metdata-Jan-Dec2007.csv", "data/MetData-31-3c.csv"};
+
+    // Test that parallel loading gives the same data as loading one file at a time
+    DataProcessor sequential;
+    for (const std::string& filename : filenames) {
+        sequential.LoadData(filename);
+    }
+    DataProcessor parallel;
+    bool result1 = parallel.LoadFiles(filenames, 4);
+    bool same = result1 && sequential.GetYears() == parallel.GetYears();
+    for (int month = 1; same && month <= 12; ++month) {
+        same = sequential.Search(month, 2007).size() == parallel.Search(month, 2007).size();
+    }
+    std::cout << "TestLoadFiles - Test 1: " << (same ? "Pass" : "Fail") << std::endl;
+
+    // Test that a missing file fails the whole load
+    DataProcessor missing;
+    bool result2 = missing.LoadFiles({"data/MetData-31-3b.csv", "data/non_existent_file.csv"}, 2);
+    std::cout << "TestLoadFiles - Test 2: " << (!result2 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestStatsAccumulator() {
+    const double values[] = {1e9 + 4, 1e9 + 7, 1e9 + 13, 1e9 + 16};
+
+    // Test that a large mean does not swamp the variance (expected 22.5)
+    RunningStats all;
+    for (double value : values) {
+        all.Add(value);
+    }
+    bool result1 = std::fabs(all.Variance() - 22.5) < 1e-6 && all.Min() == values[0] && all.Max() == values[3];
+    std::cout << "TestStatsAccumulator - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that merging two halves gives the same statistics as one pass
+    RunningStats first;
+    RunningStats second;
+    first.Add(values[0]);
+    first.Add(values[1]);
+    second.Add(values[2]);
+    second.Add(values[3]);
+    first.Merge(second);
+    bool result2 = first.Count() == all.Count() && std::fabs(first.Mean() - all.Mean()) < 1e-6
+                   && std::fabs(first.Variance() - all.Variance()) < 1e-6 && first.Max() == all.Max();
+    std::cout << "TestStatsAccumulator - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestKernels() {
+    DataProcessor dataProcessor;
+    dataProcessor.LoadData("data/Metdata-Jan-Dec2007.csv");
+    ReadingsView year = dataProcessor.SelectYear(2007);
+    std::vector<double> temperature(year.Temperature().begin(), year.Temperature().end());
+    std::vector<double> solarRadiation(year.SolarRadiation().begin(), year.SolarRadiation().end());
+
+    // Test that every level the CPU supports agrees with the scalar kernels
+    Kernels::SetLevel(Kernels::Level::Scalar);
+    double sum = Kernels::Sum(temperature.data(), temperature.size());
+    double products = Kernels::SumProducts(temperature.data(), solarRadiation.data(), temperature.size(), 20.0, 100.0);
+    double minimum = Kernels::Min(temperature.data(), temperature.size());
+    bool same = true;
+    for (Kernels::Level level : {Kernels::Level::Avx2, Kernels::Level::Avx512}) {
+        Kernels::SetLevel(level);
+        same = same && std::fabs(Kernels::Sum(temperature.data(), temperature.size()) - sum) <= Kernels::KERNEL_TOLERANCE * std::fabs(sum)
+               && std::fabs(Kernels::SumProducts(temperature.data(), solarRadiation.data(), temperature.size(), 20.0, 100.0) - products)
+                      <= Kernels::KERNEL_TOLERANCE * std::fabs(products)
+               && Kernels::Min(temperature.data(), temperature.size()) == minimum;
+    }
+    Kernels::SetLevel(Kernels::DetectLevel());
+    std::cout << "TestKernels - Test 1 (" << Kernels::LevelName(Kernels::DetectLevel()) << "): " << (same ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestSnapshot() {
+    std::vector<std::string> filenames = {"data/Metdata-Jan-Dec2007.csv"};
+    std::remove("data/test.snapshot");
+
+    // Test that the first load writes a snapshot and the second reads the same data back
+    DataProcessor parsed;
+    parsed.SetSnapshotPath("data/test.snapshot");
+    bool result1 = parsed.LoadFiles(filenames);
+    DataProcessor restored;
+    restored.SetSnapshotPath("data/test.snapshot");
+    result1 = result1 && restored.LoadFiles(filenames) && parsed.GetYears() == restored.GetYears();
+    for (int month = 1; result1 && month <= 12; ++month) {
+        result1 = parsed.GetAggregate(month, 2007).Count() == restored.GetAggregate(month, 2007).Count()
+                  && parsed.GetAggregate(month, 2007).Total(Metric::SolarRadiation) == restored.GetAggregate(month, 2007).Total(Metric::SolarRadiation);
+    }
+    std::cout << "TestSnapshot - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that a snapshot of other files is rejected
+    std::map<int, YearColumns> rejected;
+    std::vector<SourceStamp> stamps;
+    bool result2 = Snapshot::Read("data/test.snapshot", {"data/MetData-31-3b.csv"}, SENSOR_ALL, DuplicatePolicy::KeepFirst, rejected, stamps);
+    std::cout << "TestSnapshot - Test 2: " << (!result2 && rejected.empty() ? "Pass" : "Fail") << std::endl;
+
+    // Test that hashing in pieces gives the same hash as hashing the whole file
+    std::ifstream source("data/Metdata-Jan-Dec2007.csv", std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+    SourceHasher whole, pieces;
+    whole.Update(contents.data(), contents.size());
+    for (std::size_t first = 0, length = 1; first < contents.size(); first += length, length = length % 13 + 1) {
+        pieces.Update(contents.data() + first, std::min(length, contents.size() - first));
+    }
+    SourceStamp stamp;
+    bool result3 = Snapshot::Stamp("data/Metdata-Jan-Dec2007.csv", stamp) && whole.Size() == pieces.Size()
+                   && whole.Value() == pieces.Value() && stamp.m_hash == whole.Value();
+    std::cout << "TestSnapshot - Test 3: " << (result3 ? "Pass" : "Fail") << std::endl;
+
+    // Test that a snapshot written after lines were appended does not claim to cover them
+    std::size_t half = contents.find('\n', contents.size() / 2) + 1;
+    std::ofstream("data/test_snapshot.csv", std::ios::binary) << contents.substr(0, half);
+    DataProcessor appended;
+    bool result4 = appended.LoadFiles({"data/test_snapshot.csv"});
+    std::ofstream("data/test_snapshot.csv", std::ios::binary | std::ios::app) << contents.substr(half);
+    result4 = result4 && appended.SaveSnapshot("data/test.snapshot", {"data/test_snapshot.csv"})
+              && !Snapshot::Read("data/test.snapshot", {"data/test_snapshot.csv"}, SENSOR_ALL, DuplicatePolicy::KeepFirst, rejected, stamps);
+    std::cout << "TestSnapshot - Test 4: " << (result4 ? "Pass" : "Fail") << std::endl;
+    std::remove("data/test_snapshot.csv");
+    std::remove("data/test.snapshot");
+}
+
+void Test::TestFollow() {
+    std::ifstream source("data/Metdata-Jan-Dec2007.csv", std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+    std::size_t half = contents.find('\n', contents.size() / 2) + 1;
+    std::ofstream("data/test_follow.csv", std::ios::binary) << contents.substr(0, half);
+
+    DataProcessor followed;
+    followed.SetFollow(true);
+    followed.LoadFiles({"data/test_follow.csv"});
+
+    // Test that nothing is added while the file is unchanged
+    bool result1 = followed.PollFollowedFiles() == 0;
+    std::cout << "TestFollow - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that appended lines are added and the statistics match a full load
+    std::ofstream("data/test_follow.csv", std::ios::binary | std::ios::app) << contents.substr(half);
+    std::size_t added = followed.PollFollowedFiles();
+    DataProcessor full;
+    full.LoadData("data/Metdata-Jan-Dec2007.csv");
+    bool result2 = added > 0 && followed.SelectYear(2007).size() == full.SelectYear(2007).size();
+    for (int month = 1; result2 && month <= 12; ++month) {
+        // Months without readings (March and April 2007) have no mean to compare
+        const MonthAggregate& followedMonth = followed.GetAggregate(month, 2007);
+        const MonthAggregate& fullMonth = full.GetAggregate(month, 2007);
+        result2 = followedMonth.Count() == fullMonth.Count()
+                  && (fullMonth.Count() == 0 || std::fabs(followedMonth.Mean(Metric::Temperature) - fullMonth.Mean(Metric::Temperature)) < 1e-9);
+    }
+    std::cout << "TestFollow - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+
+    // Test that a truncated file is no longer followed, even once it has grown past where it was
+    std::size_t rows = followed.SelectYear(2007).size();
+    std::ofstream("data/test_follow.csv", std::ios::binary) << contents.substr(0, half);
+    bool result3 = followed.PollFollowedFiles() == 0;
+    std::ofstream("data/test_follow.csv", std::ios::binary | std::ios::app) << contents.substr(half) << contents.substr(half);
+    result3 = result3 && followed.PollFollowedFiles() == 0 && followed.SelectYear(2007).size() == rows;
+    std::cout << "TestFollow - Test 3: " << (result3 ? "Pass" : "Fail") << std::endl;
+
+    // Test that a file rewritten in place is no longer followed, even when it has grown
+    std::ofstream("data/test_follow.csv", std::ios::binary) << contents;
+    DataProcessor rewritten;
+    rewritten.SetFollow(true);
+    rewritten.LoadFiles({"data/test_follow.csv"});
+    std::string changed = contents;
+    changed[changed.size() - 2] = changed[changed.size() - 2] == '0' ? '1' : '0';
+    std::ofstream("data/test_follow.csv", std::ios::binary) << changed << contents.substr(half);
+    bool result4 = rewritten.PollFollowedFiles() == 0;
+    std::cout << "TestFollow - Test 4: " << (result4 ? "Pass" : "Fail") << std::endl;
+    std::remove("data/test_follow.csv");
+}
+
+void Test::TestDuplicates() {
+    std::vector<std::string> overlapping = {"data/MetData-31-3b.csv", "data/MetData-31-3b.csv"};
+    DataProcessor single;
+    single.LoadData("data/MetData-31-3b.csv");
+
+    // Test that a file loaded twice keeps one reading per timestamp
+    DataProcessor keepFirst;
+    keepFirst.LoadFiles(overlapping);
+    bool result1 = keepFirst.SelectYear(2016).size() == single.SelectYear(2016).size()
+                   && keepFirst.GetDuplicatesRemoved() == single.SelectYear(2016).size();
+    std::cout << "TestDuplicates - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that KeepAll keeps every copy
+    DataProcessor keepAll;
+    keepAll.SetDuplicatePolicy(DuplicatePolicy::KeepAll);
+    keepAll.LoadFiles(overlapping);
+    bool result2 = keepAll.SelectYear(2016).size() == 2 * single.SelectYear(2016).size() && keepAll.GetDuplicatesRemoved() == 0;
+    std::cout << "TestDuplicates - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestCompact() {
+    DataProcessor full;
+    full.LoadData("data/Metdata-Jan-Dec2007.csv");
+    DataProcessor compact;
+    compact.SetCompactStorage(true);
+    compact.LoadData("data/Metdata-Jan-Dec2007.csv");
+    ReadingsView expected = full.SelectYear(2007);
+    ReadingsView actual = compact.SelectYear(2007);
+
+    // Test that compact storage reads back exactly the same readings
+    bool result1 = expected.size() == actual.size();
+    for (std::size_t i = 0; result1 && i < expected.size(); ++i) {
+        result1 = expected.WindSpeed()[i] == actual.WindSpeed()[i] && expected.Temperature()[i] == actual.Temperature()[i]
+                  && expected.SolarRadiation()[i] == actual.SolarRadiation()[i];
+    }
+    std::cout << "TestCompact - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that compact storage uses less than half the memory and gives the same statistics
+    bool result2 = compact.GetStorageBytes() * 2 < full.GetStorageBytes()
+                   && compact.GetAggregate(6, 2007).Mean(Metric::Temperature) == full.GetAggregate(6, 2007).Mean(Metric::Temperature);
+    std::cout << "TestCompact - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+
+    // Test that a value that does not fit the scale widens the column back to doubles
+    MetricColumn column;
+    column.PushBack(1.0);
+    column.PushBack(25.5);
+    bool compacted = column.Compact() && column.GetEncoding() == MetricColumn::Encoding::Fixed16;
+    column.PushBack(0.125);
+    bool result3 = compacted && column.GetEncoding() == MetricColumn::Encoding::Double && column[1] == 25.5 && column[2] == 0.125;
+    std::cout << "TestCompact - Test 3: " << (result3 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestDiurnal() {
+    DataProcessor dataProcessor;
+    dataProcessor.LoadData("data/Metdata-Jan-Dec2007.csv");
+
+    // Test that the hours of a month add up to the whole month
+    std::size_t count = 0;
+    for (int hour = 0; hour < HOURS_PER_DAY; ++hour) {
+        count += dataProcessor.GetHourAggregate(1, hour, 2007).Count();
+    }
+    bool result1 = count == dataProcessor.GetAggregate(1, 2007).Count();
+    std::cout << "TestDiurnal - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that the noon statistics match a scan of the readings taken between 12:00 and 12:59
+    RunningStats noon;
+    for (MonthData row : dataProcessor.Search(1, 2007)) {
+        if (row.m_hour == 12) {
+            noon.Add(row.m_solarRadiation);
+        }
+    }
+    const MonthAggregate& aggregate = dataProcessor.GetHourAggregate(1, 12, 2007);
+    bool result2 = aggregate.Count() == noon.Count()
+                   && std::fabs(aggregate.Mean(Metric::SolarRadiation) - noon.Mean()) < 1e-9;
+    std::cout << "TestDiurnal - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestBst() {
+    // Test that timestamps inserted in time order keep the tree balanced
+    Bst<Timestamp> index;
+    const int count = 100000;
+    for (int i = 0; i < count; ++i) {
+        index.insert(MakeTimestamp(2007, 1, 1) + i * 10);
+    }
+    bool result1 = index.size() == static_cast<std::size_t>(count) && index.height() <= 1.45 * std::log2(count + 2.0);
+    std::cout << "TestBst - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that lowerBound and range find the readings of one day
+    Timestamp day = MakeTimestamp(2007, 2, 1);
+    std::size_t inDay = 0;
+    index.range(day, day + MINUTES_PER_DAY, [&inDay](const Timestamp&) { ++inDay; });
+    bool result2 = *index.lowerBound(day - 5) == day && inDay == MINUTES_PER_DAY / 10;
+    std::cout << "TestBst - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+
+    // Test that removing values keeps the rest in order
+    for (int i = 0; i < count; i += 2) {
+        index.remove(MakeTimestamp(2007, 1, 1) + i * 10);
+    }
+    bool result3 = index.size() == static_cast<std::size_t>(count / 2) && !index.search(day) && index.search(day + 10);
+    Timestamp previous = 0;
+    for (Timestamp timestamp : index) {
+        result3 = result3 && previous < timestamp;
+        previous = timestamp;
+    }
+    std::cout << "TestBst - Test 3: " << (result3 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestTimeIndex() {
+    DataProcessor dataProcessor;
+    dataProcessor.LoadData("data/Metdata-Jan-Dec2007.csv");
+    ReadingsView year = dataProcessor.SelectYear(2007);
+    std::vector<Timestamp> timestamps(year.Timestamps().begin(), year.Timestamps().end());
+
+    // Test that the index agrees with std::lower_bound, including times between readings
+    TimeIndex index;
+    index.Build(Span<const Timestamp>(timestamps));
+    bool result1 = true;
+    for (Timestamp value = timestamps.front() - 20; value < timestamps.front() + 3 * MINUTES_PER_DAY; value += 3) {
+        std::size_t expected = std::lower_bound(timestamps.begin(), timestamps.end(), value) - timestamps.begin();
+        result1 = result1 && index.LowerBound(Span<const Timestamp>(timestamps), value) == expected;
+    }
+    std::cout << "TestTimeIndex - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that the readings of a day are found
+    ReadingsView day = dataProcessor.SearchDay(15, 6, 2007);
+    bool result2 = !day.empty() && day[0].m_day == 15 && day[day.size() - 1].m_day == 15
+                   && dataProcessor.SearchDay(31, 2, 2007).empty();
+    std::cout << "TestTimeIndex - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestBstBulk() {
+    std::vector<Timestamp> timestamps;
+    for (int i = 0; i < 100000; ++i) {
+        timestamps.push_back(MakeTimestamp(2007, 1, 1) + i * 10);
+    }
+
+    // Test that a sorted range builds a perfectly balanced tree in one allocation
+    Bst<Timestamp> index(timestamps.begin(), timestamps.end());
+    bool result1 = index.size() == timestamps.size() && index.height() == 17 && index.slabCount() == 1
+                   && std::equal(index.begin(), index.end(), timestamps.begin());
+    std::cout << "TestBstBulk - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that moving a tree takes its nodes and leaves the source empty
+    Bst<Timestamp> moved(std::move(index));
+    bool result2 = moved.size() == timestamps.size() && index.empty() && index.begin() == index.end();
+    index = std::move(moved);
+    result2 = result2 && index.size() == timestamps.size() && moved.empty();
+    std::cout << "TestBstBulk - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestBatch() {
+    WeatherData weatherData;
+    weatherData.LoadData("data/Metdata-Jan-Dec2007.csv");
+    QueryRunner runner(weatherData);
+
+    // Test that a query prints the same lines as the menu option it stands for
+    std::ostringstream expected;
+    weatherData.PrintAverageWindSpeed(1, 2007, expected);
+    std::ostringstream actual;
+    bool result1 = runner.Run("wind 1 2007", actual) && actual.str() == expected.str();
+    std::cout << "TestBatch - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that comments are skipped and invalid lines are reported without stopping the script
+    std::istringstream script("# comment\n\nspcc 13\ntemperature 2007\nhourly 1\n");
+    std::ostringstream output;
+    bool result2 = runner.RunScript(script, output) == 2
+                   && output.str().find("January 2007: average:") != std::string::npos;
+    std::cout << "TestBatch - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestCache() {
+    WeatherData weatherData;
+    weatherData.LoadData("data/MetData-31-3b.csv");
+
+    // Test that repeating a query prints the cached result
+    std::ostringstream first;
+    std::ostringstream second;
+    weatherData.PrintAverageTemperature(2016, first);
+    weatherData.PrintAverageTemperature(2016, second);
+    bool result1 = first.str() == second.str() && weatherData.GetCacheHits() == 1 && weatherData.GetCacheMisses() == 1;
+    std::cout << "TestCache - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that loading another year keeps the result, and the correlation is computed again
+    std::ostringstream correlation;
+    weatherData.CalculateSPCC(1, correlation);
+    weatherData.LoadData("data/Metdata-Jan-Dec2007.csv");
+    weatherData.PrintAverageTemperature(2016, second);
+    weatherData.CalculateSPCC(1, correlation);
+    bool result2 = weatherData.GetCacheHits() == 2 && weatherData.GetCacheMisses() == 3;
+    std::cout << "TestCache - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestServer() {
+    WeatherData weatherData;
+    weatherData.LoadData("data/Metdata-Jan-Dec2007.csv");
+    QueryServer server(weatherData);
+    bool started = server.Start("test_server.sock");
+    std::thread serving(&QueryServer::Run, &server);
+
+    // Test that a query is answered with the lines the menu prints
+    std::ostringstream expected;
+    weatherData.PrintAverageWindSpeed(1, 2007, expected);
+    std::string reply;
+    bool result1 = started && QueryServer::Ask("test_server.sock", "wind 1 2007", reply) && reply == expected.str();
+    std::cout << "TestServer - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that a client cannot choose the file an export writes
+    bool result2 = !QueryServer::Ask("test_server.sock", "export 2007 test_server_export.csv", reply)
+                   && !std::ifstream("test_server_export.csv").is_open();
+    std::cout << "TestServer - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+
+    // Test that an invalid query is refused and that the server stops when asked
+    bool result3 = !QueryServer::Ask("test_server.sock", "wind 13 2007", reply)
+                   && QueryServer::Ask("test_server.sock", "shutdown", reply);
+    serving.join();
+    result3 = result3 && !QueryServer::Ask("test_server.sock", "spcc 1", reply);
+    std::cout << "TestServer - Test 3: " << (result3 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestExportYears() {
+    WeatherData weatherData;
+    weatherData.LoadData("data/Metdata-Jan-Dec2007.csv");
+    weatherData.LoadData("data/MetData-31-3b.csv");
+
+    // Test that the combined file is the per-year reports in year order, whatever the thread count
+    std::ostringstream messages;
+    bool result1 = weatherData.ExportYears({}, "data/test_export_1.csv", ExportLayout::Combined, 1, messages)
+                   && weatherData.ExportYears({}, "data/test_export_4.csv", ExportLayout::Combined, 4, messages);
+    std::ostringstream expected;
+    weatherData.WriteYearReport(2007, expected);
+    weatherData.WriteYearReport(2016, expected);
+    std::ifstream combined1("data/test_export_1.csv");
+    std::ifstream combined4("data/test_export_4.csv");
+    std::stringstream text1;
+    std::stringstream text4;
+    text1 << combined1.rdbuf();
+    text4 << combined4.rdbuf();
+    result1 = result1 && text1.str() == expected.str() && text4.str() == expected.str();
+    std::cout << "TestExportYears - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that a chosen year gets its own file and an invalid year is refused
+    bool result2 = weatherData.ExportYears({2007}, "data", ExportLayout::PerYear, 0, messages)
+                   && std::ifstream(WeatherData::ExportFileName("data", 2007)).good()
+                   && !weatherData.ExportYears({-1}, "data", ExportLayout::PerYear, 0, messages);
+    std::cout << "TestExportYears - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+    std::remove("data/test_export_1.csv");
+    std::remove("data/test_export_4.csv");
+    std::remove(WeatherData::ExportFileName("data", 2007).c_str());
+}
+
+void Test::TestOutputBuffer() {
+    // Test that numbers and padded fields come out as the stream manipulators print them
+    const double values[] = { 0.0, -0.05, 0.25, 2.5, 1e-7, 123456.5, 999999.5, 1479056.0 };
+    std::ostringstream expected;
+    std::ostringstream actual;
+    {
+        OutputBuffer buffer(actual);
+        for (double value : values) {
+            expected << std::setw(15) << std::left << value << std::fixed << std::setprecision(1) << value << std::defaultfloat
+                     << std::setprecision(6) << "\n";
+            std::size_t field = buffer.Position();
+            buffer.WriteGeneral(value).PadTo(field, 15).WriteFixed(value, 1).Write('\n');
+        }
+    }
+    bool result1 = actual.str() == expected.str();
+    std::cout << "TestOutputBuffer - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that the year table is written the same through the buffer as through the stream
+    DataProcessor dataProcessor;
+    dataProcessor.LoadData("data/Metdata-Jan-Dec2007.csv");
+    std::ostringstream table;
+    dataProcessor.DisplayDataForYear(2007, table);
+    std::ostringstream firstRow;
+    MonthData first = *dataProcessor.SelectYear(2007).begin();
+    firstRow << std::setw(10) << std::left << first.m_day << "/" << first.m_month << "/" << first.m_year << std::setw(15) << std::left
+             << first.m_windSpeed << std::setw(15) << std::left << first.m_temperature << std::setw(15) << std::left << first.m_solarRadiation;
+    std::string text = table.str();
+    bool result2 = text.compare(text.find('\n') + 1, firstRow.str().size(), firstRow.str()) == 0;
+    std::cout << "TestOutputBuffer - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+}
+
+void Test::TestExportSink() {
+    DataProcessor dataProcessor;
+    dataProcessor.LoadData("data/Metdata-Jan-Dec2007.csv");
+
+    // Test that the readings of a day are streamed in time order with their values
+    ExportFilter day;
+    day.from = MakeTimestamp(2007, 1, 3);
+    day.to = MakeTimestamp(2007, 1, 4);
+    std::ostringstream csv;
+    CsvSink csvSink(csv);
+    dataProcessor.ExportReadings(day, csvSink);
+    ReadingsView rows = dataProcessor.SearchDay(3, 1, 2007);
+    std::ostringstream firstLine;
+    firstLine << "2007-01-03T00:00," << rows[0].m_windSpeed << "," << rows[0].m_temperature << "," << rows[0].m_solarRadiation;
+    std::string text = csv.str();
+    bool result1 = !rows.empty() && static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')) == rows.size() + 1
+                   && text.compare(text.find('\n') + 1, firstLine.str().size(), firstLine.str()) == 0;
+    std::cout << "TestExportSink - Test 1: " << (result1 ? "Pass" : "Fail") << std::endl;
+
+    // Test that a whole month is exported with the statistics computed at load time, in little-endian records
+    ExportFilter january;
+    january.firstYear = 2007;
+    january.lastYear = 2007;
+    january.month = 1;
+    std::ostringstream binary;
+    BinarySink binarySink(binary);
+    dataProcessor.ExportAggregates(january, binarySink);
+    std::string bytes = binary.str();
+    std::uint64_t count = 0;
+    for (int i = 7; i >= 0 && bytes.size() == 16 + 136; --i) {
+        count = (count << 8) | static_cast<unsigned char>(bytes[16 + 8 + i]);
+    }
+    bool result2 = bytes.compare(0, 8, "WXEXPORT") == 0 && count == dataProcessor.GetAggregate(1, 2007).Count()
+                   && ExportSink::Create("ndjson", binary) != nullptr && ExportSink::Create("xml", binary) == nullptr;
+    std::cout << "TestExportSink - Test 2: " << (result2 ? "Pass" : "Fail") << std::endl;
+}
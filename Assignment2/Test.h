@@ -1,10 +1,17 @@
 #ifndef TEST_H
 #define TEST_H
 
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include <vector>
 #include "WeatherData.h"
+#include "Snapshot.h"
+#include "Bst.h"
+#include "QueryRunner.h"
+#include "QueryServer.h"
+#include "OutputBuffer.h"
+#include "ExportSink.h"
 
 class Test {
 public:
@@ -20,6 +27,24 @@ private:
     void TestDisplayDataForYear();
     void TestIsYearValid();
     void TestCalculateSPCC();
+    void TestLoadModes();
+    void TestLoadFiles();
+    void TestStatsAccumulator();
+    void TestKernels();
+    void TestSnapshot();
+    void TestFollow();
+    void TestDuplicates();
+    void TestCompact();
+    void TestDiurnal();
+    void TestBst();
+    void TestTimeIndex();
+    void TestBstBulk();
+    void TestBatch();
+    void TestCache();
+    void TestServer();
+    void TestExportYears();
+    void TestOutputBuffer();
+    void TestExportSink();
 
 };
 
@@ -0,0 +1,69 @@
+#include "TimeIndex.h"
+
+TimeIndex::TimeIndex() : m_keys(1), m_blocks(1, 0), m_rows(0) {}
+
+// Visit the slots of the implicit tree in order and give them the block keys in ascending order
+void TimeIndex::Build(Span<const Timestamp> timestamps) {
+    const std::size_t blocks = (timestamps.size() + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    m_keys.assign(blocks + 1, 0);
+    m_blocks.assign(blocks + 1, 0);
+    m_blocks[0] = static_cast<std::uint32_t>(blocks);
+    m_rows = timestamps.size();
+    if (blocks == 0) {
+        return;
+    }
+
+    std::size_t slot = 1;
+    while (2 * slot <= blocks) {
+        slot *= 2;
+    }
+    for (std::size_t block = 0; block < blocks; ++block) {
+        m_keys[slot] = timestamps[block * BLOCK_ROWS];
+        m_blocks[slot] = static_cast<std::uint32_t>(block);
+
+        // Step to the next slot in order: the leftmost of the right subtree, or up past every right turn
+        if (2 * slot + 1 <= blocks) {
+            slot = 2 * slot + 1;
+            while (2 * slot <= blocks) {
+                slot *= 2;
+            }
+        } else {
+            while (slot & 1) {
+                slot >>= 1;
+            }
+            slot >>= 1;
+        }
+    }
+}
+
+std::size_t TimeIndex::LowerBound(Span<const Timestamp> timestamps, Timestamp value) const {
+    const std::size_t blocks = m_keys.size() - 1;
+    const Timestamp* keys = m_keys.data();
+
+    // Go right while the key is less than the value; the comparison becomes the low bit of the slot
+    std::size_t slot = 1;
+    while (slot <= blocks) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(keys + (slot * BLOCK_ROWS < blocks ? slot * BLOCK_ROWS : 0));
+#endif
+        slot = 2 * slot + (keys[slot] < value ? 1 : 0);
+    }
+    // Undo the right turns taken after the last left turn; that left turn was at the first key >= value
+    while (slot & 1) {
+        slot >>= 1;
+    }
+    slot >>= 1;
+
+    // Every row before the first block whose key is >= value is in the previous block or earlier
+    const std::size_t block = m_blocks[slot];
+    if (block == 0) {
+        return 0;
+    }
+    const std::size_t first = (block - 1) * BLOCK_ROWS;
+    const std::size_t last = block * BLOCK_ROWS < m_rows ? block * BLOCK_ROWS : m_rows;
+    std::size_t before = 0;
+    for (std::size_t row = first; row < last; ++row) {
+        before += timestamps[row] < value ? 1 : 0;
+    }
+    return first + before;
+}
@@ -0,0 +1,138 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <cstdint>
+
+/**
+ * @brief A reading time as whole minutes since 1/01/1970 0:00 in station time (WAST).
+ *
+ * A 32-bit count of minutes covers the years 1 to 5999, and timestamps sort in time order.
+ */
+typedef std::int32_t Timestamp;
+
+const int HOURS_PER_DAY = 24;
+const int MINUTES_PER_DAY = HOURS_PER_DAY * 60;
+const int MIN_TIMESTAMP_YEAR = 1;
+const int MAX_TIMESTAMP_YEAR = 5999;
+
+/**
+ * @brief Count the days from 1/01/1970 to a date in the proleptic Gregorian calendar.
+ *
+ * @param year The year.
+ * @param month The month (1-12).
+ * @param day The day of the month (1-31).
+ * @return int The number of days, negative for dates before 1970.
+ */
+inline int DaysFromCivil(int year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * @brief Convert a day count from 1/01/1970 back into a date.
+ *
+ * @param days The number of days since 1/01/1970.
+ * @param year Receives the year.
+ * @param month Receives the month (1-12).
+ * @param day Receives the day of the month (1-31).
+ */
+inline void CivilFromDays(int days, int& year, int& month, int& day) {
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const int dayOfEra = days - era * 146097;
+    const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int shiftedMonth = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+/**
+ * @brief Get the number of days in a month.
+ *
+ * @param year The year (used for February in leap years).
+ * @param month The month (1-12).
+ * @return int The number of days in the month.
+ */
+inline int DaysInMonth(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+/**
+ * @brief Check if a date exists and can be stored as a Timestamp.
+ *
+ * @param year The year.
+ * @param month The month.
+ * @param day The day of the month.
+ * @return true If the date is valid.
+ */
+inline bool IsValidDate(int year, int month, int day) {
+    return year >= MIN_TIMESTAMP_YEAR && year <= MAX_TIMESTAMP_YEAR && month >= 1 && month <= 12
+           && day >= 1 && day <= DaysInMonth(year, month);
+}
+
+/**
+ * @brief Build a timestamp from a valid date and a time of day.
+ *
+ * @param year The year.
+ * @param month The month (1-12).
+ * @param day The day of the month.
+ * @param minuteOfDay The minutes since midnight (0-1439).
+ * @return Timestamp The minutes since 1/01/1970 0:00.
+ */
+inline Timestamp MakeTimestamp(int year, int month, int day, int minuteOfDay = 0) {
+    return static_cast<Timestamp>(DaysFromCivil(year, month, day) * MINUTES_PER_DAY + minuteOfDay);
+}
+
+/**
+ * @brief Get the first timestamp of a month.
+ *
+ * @param year The year.
+ * @param month The month (1-12), or 13 for January of the next year.
+ * @return Timestamp The timestamp of midnight on the first day of the month.
+ */
+inline Timestamp MonthStart(int year, int month) {
+    return month > 12 ? MakeTimestamp(year + 1, 1, 1) : MakeTimestamp(year, month, 1);
+}
+
+/**
+ * @brief Split a timestamp into its date.
+ *
+ * @param timestamp The minutes since 1/01/1970 0:00.
+ * @param year Receives the year.
+ * @param month Receives the month (1-12).
+ * @param day Receives the day of the month.
+ */
+inline void SplitTimestamp(Timestamp timestamp, int& year, int& month, int& day) {
+    int days = timestamp >= 0 ? timestamp / MINUTES_PER_DAY : (timestamp - (MINUTES_PER_DAY - 1)) / MINUTES_PER_DAY;
+    CivilFromDays(days, year, month, day);
+}
+
+/**
+ * @brief Get the time of day of a timestamp.
+ *
+ * @param timestamp The minutes since 1/01/1970 0:00.
+ * @return int The minutes since midnight (0-1439).
+ */
+inline int MinuteOfDay(Timestamp timestamp) {
+    return (timestamp % MINUTES_PER_DAY + MINUTES_PER_DAY) % MINUTES_PER_DAY;
+}
+
+/**
+ * @brief Get the hour of day of a timestamp.
+ *
+ * @param timestamp The minutes since 1/01/1970 0:00.
+ * @return int The hour (0-23).
+ */
+inline int HourOfDay(Timestamp timestamp) {
+    return MinuteOfDay(timestamp) / 60;
+}
+
+#endif // TIMESTAMP_H
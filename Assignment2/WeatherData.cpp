@@ -1,56 +1,76 @@
 #include "WeatherData.h"
+#include "OutputBuffer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
-WeatherData::WeatherData(int selectedYear) : year(selectedYear), dataTree(), dataFiles() {}
+
+WeatherData::WeatherData(int selectedYear) : year(selectedYear), dataTree(), dataFiles(), resultCache(), cacheMutex(), cacheHits(0), cacheMisses(0) {}
 
 bool WeatherData::LoadData(const std::string& filename) {
     return dataTree.LoadData(filename);
 }
 
-// modify the CalculateAverage method to take a pointer to a member function of MonthData
-double WeatherData::CalculateAverage(const std::vector<MonthData>& values, double (MonthData::*data)() const) {
-    double sum = 0.0;
-    for (const MonthData& value : values) {
-        sum += (value.*data)(); // call the member function through the pointer
-    }
-    return sum / values.size();
+bool WeatherData::LoadFiles(const std::vector<std::string>& filenames, unsigned threadCount) {
+    return dataTree.LoadFiles(filenames, threadCount);
 }
 
-double WeatherData::CalculateAverage(const std::vector<double>& data) {
-    double sum = 0.0;
-    int count = 0;
+void WeatherData::SetSnapshotPath(const std::string& path) {
+    dataTree.SetSnapshotPath(path);
+}
 
-    for (const double& value : data) {
-        sum += value;
-        count++;
-    }
+bool WeatherData::SaveSnapshot(const std::string& path, const std::vector<std::string>& filenames) const {
+    return dataTree.SaveSnapshot(path, filenames);
+}
 
-    if (count > 0) {
-        return sum / count;
+void WeatherData::SetDuplicatePolicy(DuplicatePolicy policy) {
+    dataTree.SetDuplicatePolicy(policy);
+}
+
+void WeatherData::SetCompactStorage(bool enabled) {
+    dataTree.SetCompactStorage(enabled);
+}
+
+void WeatherData::SetFollow(bool enabled) {
+    dataTree.SetFollow(enabled);
+}
+
+std::size_t WeatherData::PollFollowedFiles() {
+    return dataTree.PollFollowedFiles();
+}
+
+// modify the CalculateAverage method to take a pointer to a member function that returns a column
+double WeatherData::CalculateAverage(const ReadingsView& values, ColumnSpan (ReadingsView::*data)() const) {
+    RunningStats stats;
+    stats.Add((values.*data)()); // get the contiguous column through the pointer
+    return stats.Mean();
+}
+
+double WeatherData::CalculateAverage(const std::vector<double>& data) {
+    RunningStats stats;
+    stats.Add(Span<const double>(data));
+
+    if (stats.Count() > 0) {
+        return stats.Mean();
     }
     else {
         return 0.0;
     }
 }
 
-// modify the CalculateTotal method to take a pointer to a member function of MonthData
-double WeatherData::CalculateTotal(const std::vector<MonthData>& values, double (MonthData::*data)() const) {
-    double sum = 0.0;
-    for (const MonthData& value : values) {
-        sum += (value.*data)(); // call the member function through the pointer
-    }
-    return sum;
+// modify the CalculateTotal method to take a pointer to a member function that returns a column
+double WeatherData::CalculateTotal(const ReadingsView& values, ColumnSpan (ReadingsView::*data)() const) {
+    RunningStats stats;
+    stats.Add((values.*data)()); // get the contiguous column through the pointer
+    return stats.Total();
 }
 
-// modify the CalculateStandardDeviation method to take a pointer to a member function of MonthData
-double WeatherData::CalculateStandardDeviation(const std::vector<MonthData>& values, double (MonthData::*data)() const) {
-    double mean = CalculateAverage(values, data);
-    double variance = 0.0;
-    for (const MonthData& value : values) {
-        variance += pow((value.*data)() - mean, 2); // call the member function through the pointer
-    }
-    variance /= values.size();
-    return sqrt(variance);
+// modify the CalculateStandardDeviation method to take a pointer to a member function that returns a column
+double WeatherData::CalculateStandardDeviation(const ReadingsView& values, ColumnSpan (ReadingsView::*data)() const) {
+    RunningStats stats;
+    stats.Add((values.*data)()); // mean and spread in a single pass over the column
+    return sqrt(stats.Variance());
 }
 
 std::string WeatherData::GetMonthName(int month) {
@@ -60,123 +80,86 @@ std::string WeatherData::GetMonthName(int month) {
     };
     return monthNames[month - 1];
 }
-void WeatherData::PrintAverageWindSpeed(int month, int selectedYear) {
-    std::vector<MonthData> monthDataList = dataTree.Search(month, selectedYear);
-    // pass the pointer to the getWindSpeed member function of MonthData
-    double average = CalculateAverage(monthDataList, &MonthData::getWindSpeed);
-    double stdev = CalculateStandardDeviation(monthDataList, &MonthData::getWindSpeed);
+void WeatherData::FormatAverageWindSpeed(int month, int selectedYear, std::ostream& out) {
+    // the statistics of the month were computed when the data was loaded
+    const MonthAggregate& aggregate = dataTree.GetAggregate(month, selectedYear);
+    double average = aggregate.Mean(Metric::WindSpeed);
+    double stdev = sqrt(aggregate.Variance(Metric::WindSpeed));
 
 
-    if (monthDataList.empty()) {
-        std::cout << GetMonthName(month) << " " << selectedYear << ": No Data" << std::endl;
+    if (aggregate.Count() == 0) {
+        out << GetMonthName(month) << " " << selectedYear << ": No Data" << std::endl;
     } else {
-        std::cout << GetMonthName(month) << " " << selectedYear << ":" << std::endl;
-        std::cout << "Average speed: " << std::fixed << std::setprecision(1) << average << " km/h" << std::endl;
-        std::cout << "Sample stdev: " << std::fixed << std::setprecision(1) << stdev << std::endl;
+        out << GetMonthName(month) << " " << selectedYear << ":" << std::endl;
+        out << "Average speed: " << std::fixed << std::setprecision(1) << average << " km/h" << std::endl;
+        out << "Sample stdev: " << std::fixed << std::setprecision(1) << stdev << std::endl;
     }
 }
 
 
 
-void WeatherData::PrintAverageTemperature(int selectedYear) {
+void WeatherData::FormatAverageTemperature(int selectedYear, std::ostream& out) {
     for (int month = 1; month <= 12; ++month) {
-        std::vector<MonthData> monthDataList = dataTree.Search(month, selectedYear);
-        // pass the pointer to the temperature member function of MonthData
-        double average = CalculateAverage(monthDataList, &MonthData::getTemperature);
-        double stdev = CalculateStandardDeviation(monthDataList, &MonthData::getTemperature);
+        const MonthAggregate& aggregate = dataTree.GetAggregate(month, selectedYear);
+        double average = aggregate.Mean(Metric::Temperature);
+        double stdev = sqrt(aggregate.Variance(Metric::Temperature));
 
-        if (monthDataList.empty()) {
-            std::cout << GetMonthName(month) << " " << selectedYear << ": No Data" << std::endl;
+        if (aggregate.Count() == 0) {
+            out << GetMonthName(month) << " " << selectedYear << ": No Data" << std::endl;
         } else {
-            std::cout << GetMonthName(month) << " " << selectedYear << ": average: " << std::fixed << std::setprecision(1)
+            out << GetMonthName(month) << " " << selectedYear << ": average: " << std::fixed << std::setprecision(1)
                       << average << " degrees C, stdev: " << std::fixed << std::setprecision(1) << stdev << std::endl;
         }
     }
 }
 
 
-void WeatherData::PrintSolarRadiation(int selectedYear) {
+void WeatherData::FormatSolarRadiation(int selectedYear, std::ostream& out) {
     for (int month = 1; month <= 12; ++month) {
-        std::vector<MonthData> monthDataList = dataTree.Search(month, selectedYear);
-        // pass the pointer to the solarRadiation member function of MonthData
-        double total = CalculateTotal(monthDataList, &MonthData::getSolarRadiation);
+        const MonthAggregate& aggregate = dataTree.GetAggregate(month, selectedYear);
+        double total = aggregate.Total(Metric::SolarRadiation);
 
-        if (monthDataList.empty()) {
-            std::cout << GetMonthName(month) << " " << selectedYear << ": No Data" << std::endl;
+        if (aggregate.Count() == 0) {
+            out << GetMonthName(month) << " " << selectedYear << ": No Data" << std::endl;
         } else {
-            std::cout << GetMonthName(month) << " " << selectedYear << ": " << std::fixed << std::setprecision(1) << total
+            out << GetMonthName(month) << " " << selectedYear << ": " << std::fixed << std::setprecision(1) << total
                       << " kWh/m2" << std::endl;
         }
     }
 }
-void WeatherData::CalculateSPCC(int month) {
-    // Get the data from BST
-    const std::map<int, std::vector<MonthData>>& allData = dataTree.GetData();
+void WeatherData::FormatDiurnalProfile(int month, int selectedYear, std::ostream& out) {
+    if (dataTree.GetAggregate(month, selectedYear).Count() == 0) {
+        out << GetMonthName(month) << " " << selectedYear << ": No Data" << std::endl;
+        return;
+    }
+
+    out << GetMonthName(month) << " " << selectedYear << " by hour of day:" << std::endl;
+    for (int hour = 0; hour < HOURS_PER_DAY; ++hour) {
+        const MonthAggregate& aggregate = dataTree.GetHourAggregate(month, hour, selectedYear);
+        out << std::setw(2) << std::setfill('0') << hour << ":00 " << std::setfill(' ');
+        if (aggregate.Count() == 0) {
+            out << "No Data" << std::endl;
+        } else {
+            out << "wind: " << std::fixed << std::setprecision(1) << aggregate.Mean(Metric::WindSpeed) << " km/h, temperature: "
+                      << aggregate.Mean(Metric::Temperature) << " degrees C, solar radiation: "
+                      << aggregate.Mean(Metric::SolarRadiation) << " W/m2" << std::endl;
+        }
+    }
+}
 
+void WeatherData::FormatSPCC(int month, std::ostream& out) {
     std::vector<double> s_t_values;
     std::vector<double> s_r_values;
     std::vector<double> t_r_values;
 
-    for (const auto& yearDataPair : allData) {
-        // Rename the local variable to avoid shadowing
-        //int yearData = yearDataPair.first;
-        const std::vector<MonthData>& monthData = yearDataPair.second;
-
-        double sum_s = 0.0;
-        double sum_t = 0.0;
-        double sum_r = 0.0;
-        double sum_s_t = 0.0;
-        double sum_s_r = 0.0;
-        double sum_t_r = 0.0;
-        int count = 0;
-
-        for (const MonthData& data : monthData) {
-            if (data.m_month == month) {
-                sum_s += data.m_windSpeed;
-                sum_t += data.m_temperature;
-                sum_r += data.m_solarRadiation;
-                sum_s_t += data.m_windSpeed * data.m_temperature;
-                sum_s_r += data.m_windSpeed * data.m_solarRadiation;
-                sum_t_r += data.m_temperature * data.m_solarRadiation;
-                count++;
-            }
-        }
-
-        if (count > 0) {
-            double mean_s = sum_s / count;
-            double mean_t = sum_t / count;
-            double mean_r = sum_r / count;
-            double mean_s_t = sum_s_t / count;
-            double mean_s_r = sum_s_r / count;
-            double mean_t_r = sum_t_r / count;
-
-            double covariance_s_t = mean_s_t - (mean_s * mean_t);
-            double covariance_s_r = mean_s_r - (mean_s * mean_r);
-            double covariance_t_r = mean_t_r - (mean_t * mean_r);
-
-            double variance_s = 0.0;
-            double variance_t = 0.0;
-            double variance_r = 0.0;
-
-            for (const MonthData& data : monthData) {
-                if (data.m_month == month) {
-                    variance_s += pow(data.m_windSpeed - mean_s, 2);
-                    variance_t += pow(data.m_temperature - mean_t, 2);
-                    variance_r += pow(data.m_solarRadiation - mean_r, 2);
-                }
-            }
-
-            variance_s /= count;
-            variance_t /= count;
-            variance_r /= count;
+    for (int yearData : dataTree.GetYears()) {
+        // The sums of the month, including the sums of products, were built at load time
+        const MonthAggregate& aggregate = dataTree.GetAggregate(month, yearData);
 
-            double s_t_spcc = covariance_s_t / sqrt(variance_s * variance_t);
-            double s_r_spcc = covariance_s_r / sqrt(variance_s * variance_r);
-            double t_r_spcc = covariance_t_r / sqrt(variance_t * variance_r);
-
-            s_t_values.push_back(s_t_spcc);
-            s_r_values.push_back(s_r_spcc);
-            t_r_values.push_back(t_r_spcc);
+        if (aggregate.Count() > 0) {
+            s_t_values.push_back(aggregate.Correlation(Metric::WindSpeed, Metric::Temperature));
+            s_r_values.push_back(aggregate.Correlation(Metric::WindSpeed, Metric::SolarRadiation));
+            t_r_values.push_back(aggregate.Correlation(Metric::Temperature, Metric::SolarRadiation));
         }
     }
 
@@ -188,57 +171,135 @@ double overall_t_r_spcc = CalculateAverage(t_r_values);
 
 
     // Display the results
-    std::cout << "Sample Pearson Correlation Coefficient for " << GetMonthName(month) << std::endl;
-    std::cout << "S_T: " << std::fixed << std::setprecision(2) << overall_s_t_spcc << std::endl;
-    std::cout << "S_R: " << std::fixed << std::setprecision(2) << overall_s_r_spcc << std::endl;
-    std::cout << "T_R: " << std::fixed << std::setprecision(2) << overall_t_r_spcc << std::endl;
+    out << "Sample Pearson Correlation Coefficient for " << GetMonthName(month) << std::endl;
+    out << "S_T: " << std::fixed << std::setprecision(2) << overall_s_t_spcc << std::endl;
+    out << "S_R: " << std::fixed << std::setprecision(2) << overall_s_r_spcc << std::endl;
+    out << "T_R: " << std::fixed << std::setprecision(2) << overall_t_r_spcc << std::endl;
+}
+
+
+// Print a result from the cache if the data it was computed from has not changed since
+void WeatherData::PrintCached(CachedQuery query, int month, int selectedYear, std::uint64_t revision, std::ostream& out,
+                              const std::function<void(std::ostream&)>& format) {
+    const std::tuple<int, int, int> key(static_cast<int>(query), month, selectedYear);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto found = resultCache.find(key);
+        if (found != resultCache.end() && found->second.revision == revision) {
+            ++cacheHits;
+            out << found->second.text;
+            return;
+        }
+        ++cacheMisses;
+    }
+
+    // Format outside the lock so that other queries are not held up
+    std::ostringstream text;
+    format(text);
+    out << text.str();
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    resultCache[key] = CachedResult{revision, text.str()};
 }
 
+void WeatherData::PrintAverageWindSpeed(int month, int selectedYear, std::ostream& out) {
+    PrintCached(CachedQuery::WindSpeed, month, selectedYear, dataTree.GetRevision(selectedYear), out,
+                [this, month, selectedYear](std::ostream& text) { FormatAverageWindSpeed(month, selectedYear, text); });
+}
+
+void WeatherData::PrintAverageTemperature(int selectedYear, std::ostream& out) {
+    PrintCached(CachedQuery::Temperature, 0, selectedYear, dataTree.GetRevision(selectedYear), out,
+                [this, selectedYear](std::ostream& text) { FormatAverageTemperature(selectedYear, text); });
+}
+
+void WeatherData::PrintSolarRadiation(int selectedYear, std::ostream& out) {
+    PrintCached(CachedQuery::SolarRadiation, 0, selectedYear, dataTree.GetRevision(selectedYear), out,
+                [this, selectedYear](std::ostream& text) { FormatSolarRadiation(selectedYear, text); });
+}
+
+void WeatherData::PrintDiurnalProfile(int month, int selectedYear, std::ostream& out) {
+    PrintCached(CachedQuery::DiurnalProfile, month, selectedYear, dataTree.GetRevision(selectedYear), out,
+                [this, month, selectedYear](std::ostream& text) { FormatDiurnalProfile(month, selectedYear, text); });
+}
+
+// The correlation of a month averages every year, so it depends on the revision of the whole data
+void WeatherData::CalculateSPCC(int month, std::ostream& out) {
+    PrintCached(CachedQuery::Correlation, month, 0, dataTree.GetRevision(), out,
+                [this, month](std::ostream& text) { FormatSPCC(month, text); });
+}
+
+std::size_t WeatherData::GetCacheHits() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return cacheHits;
+}
+
+std::size_t WeatherData::GetCacheMisses() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return cacheMisses;
+}
+
+void WeatherData::ClearCache() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    resultCache.clear();
+    cacheHits = 0;
+    cacheMisses = 0;
+}
 
 int WeatherData::GetCurrentYear() {
     // Get the current time
     std::time_t t = std::time(nullptr);
-    // Convert it to a tm struct
-    std::tm* tm = std::localtime(&t);
+    // Convert it to a tm struct, with the reentrant form so that server threads can call it at once
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
     // Return the year field (note that it is offset by 1900)
-    return tm->tm_year + 1900;
+    return tm.tm_year + 1900;
 }
 
-void WeatherData::WriteDataToFile(int selectedYear) {
+void WeatherData::WriteDataToFile(int selectedYear, const std::string& path, std::ostream& out) {
     // Check if the selectedYear is valid
     if (selectedYear < 0 || selectedYear > GetCurrentYear()) {
-        std::cout << "Invalid year: " << selectedYear << std::endl;
+        out << "Invalid year: " << selectedYear << std::endl;
         return;
     }
 
-    std::ofstream file("data/WindTempSolar.csv");
+    // The messages name the file without its directory
+    const std::string fileName = path.substr(path.find_last_of("/\\") + 1);
+    std::ofstream file(path);
     if (!file.is_open()) {
-        std::cout << "Error opening file: WindTempSolar.csv" << std::endl;
+        out << "Error opening file: " << fileName << std::endl;
         return;
     }
 
-    file << selectedYear << std::endl;
+    WriteYearReport(selectedYear, file);
+    file.close();
+    out << "Data written to " << fileName << std::endl;
+}
 
-    bool yearDataAvailable = false;
+void WeatherData::WriteYearReport(int selectedYear, std::ostream& file) const {
+    OutputBuffer buffer(file);
+    buffer.Write(static_cast<long long>(selectedYear)).Write('\n');
 
-    // Define a small positive number for floating point comparison
-    //const double EPSILON = 1e-6;
+    bool yearDataAvailable = false;
 
     for (int month = 1; month <= 12; ++month) {
-        std::vector<MonthData> monthDataList = dataTree.Search(month, selectedYear);
-        // pass the pointers to the member functions of MonthData
-        double windSpeedAverage = CalculateAverage(monthDataList, &MonthData::getWindSpeed);
-        double windSpeedStdev = CalculateStandardDeviation(monthDataList, &MonthData::getWindSpeed);
-        double temperatureAverage = CalculateAverage(monthDataList, &MonthData::getTemperature);
-        double temperatureStdev = CalculateStandardDeviation(monthDataList, &MonthData::getTemperature);
-        double solarRadiationSum = CalculateTotal(monthDataList, &MonthData::getSolarRadiation);
+        // read the statistics of the month from the aggregates built at load time
+        const MonthAggregate& aggregate = dataTree.GetAggregate(month, selectedYear);
+        double windSpeedAverage = aggregate.Mean(Metric::WindSpeed);
+        double windSpeedStdev = sqrt(aggregate.Variance(Metric::WindSpeed));
+        double temperatureAverage = aggregate.Mean(Metric::Temperature);
+        double temperatureStdev = sqrt(aggregate.Variance(Metric::Temperature));
+        double solarRadiationSum = aggregate.Total(Metric::SolarRadiation);
 
         // Write the data to the file if there is any
-        if (!monthDataList.empty()) {
-            file << GetMonthName(month) << ","
-                 << std::fixed << std::setprecision(1) << windSpeedAverage << "(" << windSpeedStdev << "),"
-                 << std::fixed << std::setprecision(1) << temperatureAverage << "(" << temperatureStdev << "),"
-                 << std::fixed << std::setprecision(1) << solarRadiationSum << std::endl;
+        if (aggregate.Count() > 0) {
+            buffer.Write(GetMonthName(month)).Write(',')
+                  .WriteFixed(windSpeedAverage, 1).Write('(').WriteFixed(windSpeedStdev, 1).Write("),")
+                  .WriteFixed(temperatureAverage, 1).Write('(').WriteFixed(temperatureStdev, 1).Write("),")
+                  .WriteFixed(solarRadiationSum, 1).Write('\n');
 
             yearDataAvailable = true;
         }
@@ -246,16 +307,92 @@ void WeatherData::WriteDataToFile(int selectedYear) {
 
     // Write no data if there is none for the year
     if (!yearDataAvailable) {
-        file << "No data for that year" << std::endl; // Changed this line
+        buffer.Write("No data for that year\n"); // Changed this line
     }
+}
 
-    file.close();
-    std::cout << "Data written to WindTempSolar.csv" << std::endl;
+// Format the report of each year on a worker thread, then write the files in year order
+bool WeatherData::ExportYears(const std::vector<int>& selectedYears, const std::string& path, ExportLayout layout,
+                              unsigned threadCount, std::ostream& out) {
+    std::vector<int> years = selectedYears.empty() ? dataTree.GetYears() : selectedYears;
+    std::sort(years.begin(), years.end());
+    years.erase(std::unique(years.begin(), years.end()), years.end());
+    for (int selectedYear : years) {
+        if (selectedYear < 0 || selectedYear > GetCurrentYear()) {
+            out << "Invalid year: " << selectedYear << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<std::string> reports(years.size());
+    std::vector<char> written(years.size(), 1);
+    std::atomic<std::size_t> nextYear(0);
+    auto worker = [&]() {
+        for (std::size_t i = nextYear++; i < years.size(); i = nextYear++) {
+            std::ostringstream report;
+            WriteYearReport(years[i], report);
+            reports[i] = report.str();
+            // Each year has its own file, so the worker writes it as soon as it is formatted
+            if (layout == ExportLayout::PerYear) {
+                std::ofstream file(ExportFileName(path, years[i]), std::ios::binary);
+                file << reports[i];
+                written[i] = file.good() ? 1 : 0;
+                reports[i].clear();
+            }
+        }
+    };
+
+    unsigned threads = threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threadCount;
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, years.size()));
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    bool ok = true;
+    if (layout == ExportLayout::Combined) {
+        std::ofstream file(path, std::ios::binary);
+        for (const std::string& report : reports) {
+            file << report;
+        }
+        ok = file.good();
+        out << (ok ? "Data written to " : "Error writing file: ") << path << std::endl;
+    } else {
+        for (std::size_t i = 0; i < years.size(); ++i) {
+            out << (written[i] ? "Data written to " : "Error writing file: ") << ExportFileName(path, years[i]) << std::endl;
+            ok = ok && written[i];
+        }
+    }
+    return ok;
+}
+
+std::string WeatherData::ExportFileName(const std::string& directory, int selectedYear) {
+    std::string name = "WindTempSolar_" + std::to_string(selectedYear) + ".csv";
+    if (directory.empty()) {
+        return name;
+    }
+    char last = directory.back();
+    return last == '/' || last == '\\' ? directory + name : directory + "/" + name;
 }
 
 // Check if the entered year exists in the loaded data
 bool WeatherData::IsYearValid(int selectedYear) const {
     // Check if selectedYear exists in the loaded data
-    return dataTree.GetData().find(selectedYear) != dataTree.GetData().end();
+    return dataTree.HasYear(selectedYear);
 }
 
+void WeatherData::StreamExport(const ExportFilter& filter, ExportSink::Content content, ExportSink& sink) const {
+    if (content == ExportSink::Content::Readings) {
+        dataTree.ExportReadings(filter, sink);
+    } else {
+        dataTree.ExportAggregates(filter, sink);
+    }
+}
+
+void WeatherData::DisplayDataForYear(int selectedYear, std::ostream& out) const {
+    dataTree.DisplayDataForYear(selectedYear, out);
+}
@@ -7,12 +7,25 @@
 #include <fstream>
 #include <sstream>
 #include <cmath>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include "DataProcessor.h"
 
 
+/**
+ * @brief Where ExportYears writes the reports.
+ */
+enum class ExportLayout {
+    PerYear, // One file per year in a directory
+    Combined // Every year in one file, in ascending order
+};
+
 /**
  * @brief A class that represents weather data for a given year.
  *
@@ -26,6 +39,43 @@ private:
     DataProcessor dataTree; // The BST instance to store weather data
     std::vector<std::string> dataFiles; // The names of the files that contain weather data
 
+    /**
+     * @brief The queries whose printed results are cached.
+     */
+    enum class CachedQuery { WindSpeed, Temperature, SolarRadiation, DiurnalProfile, Correlation };
+
+    /**
+     * @brief The printed result of a query and the revision of the data it was computed from.
+     */
+    struct CachedResult {
+        std::uint64_t revision; // The revision of the year, or of the whole data, when the result was formatted
+        std::string text; // The lines printed
+    };
+
+    std::map<std::tuple<int, int, int>, CachedResult> resultCache; // The results by query, month and year (0 if not used)
+    mutable std::mutex cacheMutex; // Guards the cache and its counters
+    std::size_t cacheHits; // The number of results printed from the cache
+    std::size_t cacheMisses; // The number of results formatted because none was cached or it was out of date
+
+    /**
+     * @brief Print the result of a query, formatting it only if the cached result is missing or out of date.
+     *
+     * @param query The query.
+     * @param month The month of the query, or 0 if it does not take one.
+     * @param selectedYear The year of the query, or 0 if it does not take one.
+     * @param revision The current revision of the data the result depends on.
+     * @param out The stream the result is printed to.
+     * @param format The function that prints the result.
+     */
+    void PrintCached(CachedQuery query, int month, int selectedYear, std::uint64_t revision, std::ostream& out,
+                     const std::function<void(std::ostream&)>& format);
+
+    void FormatAverageWindSpeed(int month, int selectedYear, std::ostream& out);
+    void FormatAverageTemperature(int selectedYear, std::ostream& out);
+    void FormatSolarRadiation(int selectedYear, std::ostream& out);
+    void FormatDiurnalProfile(int month, int selectedYear, std::ostream& out);
+    void FormatSPCC(int month, std::ostream& out);
+
 public:
     /**
      * @brief Construct a new WeatherData object with a specified year.
@@ -43,6 +93,78 @@ public:
      */
     bool LoadData(const std::string& filename);
 
+    /**
+     * @brief Load several files in parallel and insert them into the BST.
+     *
+     * @param filenames The names of the files that contain weather data, in load order.
+     * @param threadCount The number of threads to use, or 0 for one per hardware thread.
+     * @return true If every file is successfully opened and read.
+     * @return false If a file cannot be opened or read.
+     */
+    bool LoadFiles(const std::vector<std::string>& filenames, unsigned threadCount = 0);
+
+    /**
+     * @brief Set the binary snapshot that LoadFiles reads instead of parsing, and writes after parsing.
+     * @param path The name of the snapshot file, or an empty string for none.
+     */
+    void SetSnapshotPath(const std::string& path);
+
+    /**
+     * @brief Write the loaded data to a binary snapshot.
+     *
+     * @param path The name of the snapshot file.
+     * @param filenames The files the data was loaded from, in load order.
+     * @return true If the snapshot is successfully written.
+     */
+    bool SaveSnapshot(const std::string& path, const std::vector<std::string>& filenames) const;
+
+    /**
+     * @brief Choose which reading later loads keep when several share a timestamp.
+     * @param policy The duplicate policy.
+     */
+    void SetDuplicatePolicy(DuplicatePolicy policy);
+
+    /**
+     * @brief Choose whether the readings are stored as fixed-point integers to save memory.
+     * @param enabled True to store readings compactly.
+     */
+    void SetCompactStorage(bool enabled);
+
+    /**
+     * @brief Choose whether files loaded from now on are followed for appended lines.
+     * @param enabled True to follow the files.
+     */
+    void SetFollow(bool enabled);
+
+    /**
+     * @brief Read the complete lines appended to the followed files and update the statistics.
+     * @return std::size_t The number of readings added.
+     */
+    std::size_t PollFollowedFiles();
+
+    /**
+     * @brief Get the number of query results printed from the cache.
+     *
+     * The printed results of PrintAverageWindSpeed, PrintAverageTemperature, PrintSolarRadiation,
+     * PrintDiurnalProfile and CalculateSPCC are kept and printed again for the same parameters.
+     * A result of one year is recomputed once readings of that year are loaded; an sPCC result
+     * is recomputed once readings of any year are loaded. The cache may be used from several threads.
+     *
+     * @return std::size_t The number of cache hits.
+     */
+    std::size_t GetCacheHits() const;
+
+    /**
+     * @brief Get the number of query results that had to be computed.
+     * @return std::size_t The number of cache misses.
+     */
+    std::size_t GetCacheMisses() const;
+
+    /**
+     * @brief Drop every cached result and reset the hit and miss counters.
+     */
+    void ClearCache();
+
     /**
      * @brief Calculate the average of a vector of values.
      *
@@ -52,31 +174,31 @@ public:
     double CalculateAverage(const std::vector<double>& data);
 
     /**
-     * @brief Calculate the average of a vector of double objects based on a specific member function.
+     * @brief Calculate the average of one metric of a set of readings based on a specific member function.
      *
-     * @param values A vector of MonthData objects.
-     * @param data Pointer to a member function of MonthData to access the desired data (e.g. &MonthData::m_windSpeed).
+     * @param values A view of the readings.
+     * @param data Pointer to a member function of ReadingsView that returns the column of the desired data (e.g. &ReadingsView::WindSpeed).
      * @return double The average of the data specified by the member function.
      */
-    double CalculateAverage(const std::vector<MonthData>& values, double (MonthData::*data)() const);
+    double CalculateAverage(const ReadingsView& values, ColumnSpan (ReadingsView::*data)() const);
 
     /**
-     * @brief Calculate the total of a vector of MonthData objects based on a specific member function.
+     * @brief Calculate the total of one metric of a set of readings based on a specific member function.
      *
-     * @param values A vector of MonthData objects.
-     * @param data Pointer to a member function of MonthData to access the desired data (e.g. &MonthData::m_windSpeed).
+     * @param values A view of the readings.
+     * @param data Pointer to a member function of ReadingsView that returns the column of the desired data (e.g. &ReadingsView::WindSpeed).
      * @return double The total of the data specified by the member function.
      */
-    double CalculateTotal(const std::vector<MonthData>& values, double (MonthData::*data)() const);
+    double CalculateTotal(const ReadingsView& values, ColumnSpan (ReadingsView::*data)() const);
 
     /**
-     * @brief Calculate the sample standard deviation of a vector of MonthData objects based on a specific member function.
+     * @brief Calculate the sample standard deviation of one metric of a set of readings based on a specific member function.
      *
-     * @param values A vector of MonthData objects.
-     * @param data Pointer to a member function of MonthData to access the desired data (e.g. &MonthData::m_windSpeed).
+     * @param values A view of the readings.
+     * @param data Pointer to a member function of ReadingsView that returns the column of the desired data (e.g. &ReadingsView::WindSpeed).
      * @return double The sample standard deviation of the data specified by the member function.
      */
-    double CalculateStandardDeviation(const std::vector<MonthData>& values, double (MonthData::*data)() const);
+    double CalculateStandardDeviation(const ReadingsView& values, ColumnSpan (ReadingsView::*data)() const);
 
     /**
      * @brief Get the month name based on its index (1-12).
@@ -84,15 +206,16 @@ public:
      * @param month The index of the month (1-12).
      * @return std::string The name of the month (e.g. January, February, etc.).
      */
-    std::string GetMonthName(int month);
+    static std::string GetMonthName(int month);
 
     /**
      * @brief Calculate and print the Sample Pearson Correlation Coefficient (sPCC)
      * between wind speed and solar radiation for a specified month.
      *
      * @param month The index of the month (1-12).
+     * @param out The stream the results are printed to.
      */
-    void CalculateSPCC(int month);
+    void CalculateSPCC(int month, std::ostream& out = std::cout);
 
     /**
      * @brief Print the average wind speed and standard deviation for a specified month
@@ -100,36 +223,96 @@ public:
      *
      * @param month The index of the month (1-12).
      * @param selectedYear The year of the weather data.
+     * @param out The stream the results are printed to.
      */
-    void PrintAverageWindSpeed(int month, int selectedYear);
+    void PrintAverageWindSpeed(int month, int selectedYear, std::ostream& out = std::cout);
 
     /**
      * @brief Print the average temperature and standard deviation for each month
      * for a given year.
      *
      * @param selectedYear The year of the weather data.
+     * @param out The stream the results are printed to.
      */
-    void PrintAverageTemperature(int selectedYear);
+    void PrintAverageTemperature(int selectedYear, std::ostream& out = std::cout);
 
     /**
      * @brief Print the total solar radiation for each month
      * for a given year.
      *
       *@param selectedYear The year of the weather data.
+      *@param out The stream the results are printed to.
       */
-    void PrintSolarRadiation(int selectedYear);
+    void PrintSolarRadiation(int selectedYear, std::ostream& out = std::cout);
+
+    /**
+     * @brief Print the average wind speed, temperature and solar radiation for each hour
+     * of the day over a month.
+     *
+     * The values are read from the hourly statistics built at load time, so the cost does
+     * not depend on the number of readings.
+     *
+     * @param month The month of the weather data.
+     * @param selectedYear The year of the weather data.
+     * @param out The stream the results are printed to.
+     */
+    void PrintDiurnalProfile(int month, int selectedYear, std::ostream& out = std::cout);
 
     /**
       *@brief Write wind speed, temperature, and solar radiation data to a CSV file
       *@param selectedYear The year of the weather data.
+      *@param path The CSV file to be written.
+      *@param out The stream the messages are printed to.
+      */
+    void WriteDataToFile(int selectedYear, const std::string& path = "data/WindTempSolar.csv", std::ostream& out = std::cout);
+
+    /**
+      *@brief Write the report of WriteDataToFile for one year: the year, then one line per month with data.
+      *@param selectedYear The year of the weather data.
+      *@param file The stream the report is written to.
+      */
+    void WriteYearReport(int selectedYear, std::ostream& file) const;
+
+    /**
+      *@brief Write the reports of many years at once, formatting the years in parallel.
+      *
+      * The reports are read from the monthly statistics built at load time. The output does
+      * not depend on the thread count: each file holds the same bytes, and the combined file
+      * lists the years in ascending order. A year without data gets the "No data" report.
+      *
+      *@param selectedYears The years to be written, or an empty vector for every loaded year.
+      *@param path The directory of the per-year files, or the combined file.
+      *@param layout Whether each year gets its own file (see ExportFileName) or all go in one.
+      *@param threadCount The number of threads to use, or 0 for one per hardware thread.
+      *@param out The stream the messages are printed to.
+      *@return true If every file was written.
+      *@return false If a year is invalid or a file cannot be written.
+      */
+    bool ExportYears(const std::vector<int>& selectedYears, const std::string& path, ExportLayout layout,
+                     unsigned threadCount = 0, std::ostream& out = std::cout);
+
+    /**
+      *@brief Get the name of the per-year file written by ExportYears.
+      *@param directory The directory of the file.
+      *@param selectedYear The year of the report.
+      *@return std::string The path directory/WindTempSolar_YEAR.csv.
+      */
+    static std::string ExportFileName(const std::string& directory, int selectedYear);
+
+    /**
+      *@brief Stream readings or monthly statistics that pass a filter to a sink (see ExportSink).
+      *@param filter The years, month and period to be exported.
+      *@param content Whether the readings or the statistics of each month are exported.
+      *@param sink The sink that writes the chosen format.
       */
-    void WriteDataToFile(int selectedYear);
+    void StreamExport(const ExportFilter& filter, ExportSink::Content content, ExportSink& sink) const;
 
     /**
       *@brief Display all weather data for a given year in a table format.
       *@param selectedYear The year of the weather data.
+      *@param out The stream the table is written to.
       */
-    void DisplayDataForYear(int selectedYear) const;
+    void DisplayDataForYear(int selectedYear, std::ostream& out = std::cout) const;
 
     /**
       *@brief Check if a given year is valid (i.e. within the range of available data).
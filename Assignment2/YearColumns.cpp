@@ -0,0 +1,268 @@
+#include "YearColumns.h"
+#include "DataLoader.h"
+
+#include <algorithm>
+#include <numeric>
+
+YearColumns::YearColumns()
+    : m_timestamps(), m_windSpeed(), m_temperature(), m_solarRadiation(), m_monthStart(), m_monthAggregates(), m_hourAggregates() {}
+
+void YearColumns::Reserve(std::size_t rows) {
+    m_timestamps.reserve(rows);
+    m_windSpeed.Reserve(rows);
+    m_temperature.Reserve(rows);
+    m_solarRadiation.Reserve(rows);
+}
+
+void YearColumns::Append(const MonthData& row) {
+    m_timestamps.push_back(MakeTimestamp(row.m_year, row.m_month, row.m_day, row.m_hour * 60 + row.m_minute));
+    m_windSpeed.PushBack(row.m_windSpeed);
+    m_temperature.PushBack(row.m_temperature);
+    m_solarRadiation.PushBack(row.m_solarRadiation);
+}
+
+// Move the rows of another year to the end of this one
+void YearColumns::Append(YearColumns& other) {
+    if (Empty()) {
+        m_timestamps.swap(other.m_timestamps);
+    } else {
+        m_timestamps.insert(m_timestamps.end(), other.m_timestamps.begin(), other.m_timestamps.end());
+    }
+    m_windSpeed.Append(other.m_windSpeed);
+    m_temperature.Append(other.m_temperature);
+    m_solarRadiation.Append(other.m_solarRadiation);
+    other = YearColumns();
+}
+
+// Append rows that continue the year in time order and fold them into the statistics
+bool YearColumns::Extend(YearColumns& other, bool strictlyAfter) {
+    if (other.Empty()) {
+        return true;
+    }
+    if (!other.IsSorted() || (!Empty() && other.m_timestamps.front() < m_timestamps.back() + (strictlyAfter ? 1 : 0))) {
+        return false;
+    }
+
+    std::size_t oldSize = Size();
+    Append(other);
+    BuildMonthIndex();
+    for (int month = 1; month <= 12; ++month) {
+        std::size_t begin = std::max<std::size_t>(m_monthStart[month - 1], oldSize);
+        if (begin >= m_monthStart[month]) {
+            continue;
+        }
+        ReadingsView rows(*this, begin, m_monthStart[month]);
+        const ColumnSpan columns[METRIC_COUNT] = {rows.WindSpeed(), rows.Temperature(), rows.SolarRadiation()};
+        MonthAggregate added;
+        added.Add(columns);
+        m_monthAggregates[month - 1].Merge(added);
+        AddHours(month, begin, m_monthStart[month]);
+    }
+    return true;
+}
+
+void YearColumns::Assign(const Timestamp* timestamps, const double* windSpeed, const double* temperature, const double* solarRadiation, std::size_t rows) {
+    m_timestamps.assign(timestamps, timestamps + rows);
+    m_windSpeed.Assign(windSpeed, rows);
+    m_temperature.Assign(temperature, rows);
+    m_solarRadiation.Assign(solarRadiation, rows);
+}
+
+void YearColumns::Compact() {
+    m_timestamps.shrink_to_fit();
+    m_windSpeed.Compact();
+    m_temperature.Compact();
+    m_solarRadiation.Compact();
+}
+
+void YearColumns::Expand() {
+    m_windSpeed.Expand();
+    m_temperature.Expand();
+    m_solarRadiation.Expand();
+}
+
+std::size_t YearColumns::Bytes() const {
+    return m_timestamps.capacity() * sizeof(Timestamp) + m_windSpeed.Bytes() + m_temperature.Bytes() + m_solarRadiation.Bytes();
+}
+
+bool YearColumns::IsSorted() const {
+    return std::is_sorted(m_timestamps.begin(), m_timestamps.end());
+}
+
+// Sort the rows through a permutation so that all four columns move together, each in its own encoding
+void YearColumns::SortByTime() {
+    if (IsSorted()) {
+        return;
+    }
+
+    std::vector<std::size_t> order(Size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+        return m_timestamps[a] < m_timestamps[b];
+    });
+
+    std::vector<Timestamp> timestamps;
+    timestamps.reserve(Size());
+    for (std::size_t index : order) {
+        timestamps.push_back(m_timestamps[index]);
+    }
+    m_timestamps.swap(timestamps);
+    m_windSpeed.Permute(order);
+    m_temperature.Permute(order);
+    m_solarRadiation.Permute(order);
+}
+
+// Compact the columns in place, keeping one row of each run of equal timestamps
+std::size_t YearColumns::RemoveDuplicates(DuplicatePolicy policy) {
+    if (policy == DuplicatePolicy::KeepAll || Size() < 2) {
+        return 0;
+    }
+
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < Size();) {
+        // Find the run of rows [i, runEnd) with the same timestamp
+        std::size_t runEnd = i + 1;
+        while (runEnd < Size() && m_timestamps[runEnd] == m_timestamps[i]) {
+            ++runEnd;
+        }
+        std::size_t source = policy == DuplicatePolicy::KeepFirst ? i : runEnd - 1;
+        if (kept != source) {
+            m_timestamps[kept] = m_timestamps[source];
+            m_windSpeed.CopyValue(kept, source);
+            m_temperature.CopyValue(kept, source);
+            m_solarRadiation.CopyValue(kept, source);
+        }
+        ++kept;
+        i = runEnd;
+    }
+
+    std::size_t removed = Size() - kept;
+    m_timestamps.resize(kept);
+    m_windSpeed.Resize(kept);
+    m_temperature.Resize(kept);
+    m_solarRadiation.Resize(kept);
+    return removed;
+}
+
+// Find the first row of each month with a binary search over the sorted timestamps
+void YearColumns::BuildMonthIndex() {
+    m_monthStart.fill(0);
+    m_timeIndex.Build(Timestamps());
+    if (Empty()) {
+        return;
+    }
+
+    int year, month, day;
+    SplitTimestamp(m_timestamps.front(), year, month, day);
+    for (int m = 1; m <= 12; ++m) {
+        auto first = std::lower_bound(m_timestamps.begin(), m_timestamps.end(), MonthStart(year, m + 1));
+        m_monthStart[m] = static_cast<std::uint32_t>(first - m_timestamps.begin());
+    }
+}
+
+ReadingsView YearColumns::Month(int month) const {
+    if (month < 1 || month > 12) {
+        return ReadingsView();
+    }
+    return ReadingsView(*this, m_monthStart[month - 1], m_monthStart[month]);
+}
+
+// Fall back to a plain binary search if rows were added since the index was built
+std::size_t YearColumns::LowerBound(Timestamp value) const {
+    if (m_timeIndex.Size() != Size()) {
+        return std::lower_bound(m_timestamps.begin(), m_timestamps.end(), value) - m_timestamps.begin();
+    }
+    return m_timeIndex.LowerBound(Timestamps(), value);
+}
+
+ReadingsView YearColumns::Period(Timestamp from, Timestamp to) const {
+    if (!(from < to)) {
+        return ReadingsView();
+    }
+    return ReadingsView(*this, LowerBound(from), LowerBound(to));
+}
+
+void YearColumns::BuildAggregates() {
+    for (int month = 1; month <= 12; ++month) {
+        ReadingsView rows = Month(month);
+        const ColumnSpan columns[METRIC_COUNT] = {rows.WindSpeed(), rows.Temperature(), rows.SolarRadiation()};
+        MonthAggregate aggregate;
+        aggregate.Add(columns);
+        m_monthAggregates[month - 1] = aggregate;
+        m_hourAggregates[month - 1].fill(MonthAggregate());
+        AddHours(month, m_monthStart[month - 1], m_monthStart[month]);
+    }
+}
+
+// The hours of a day interleave, so each row is added on its own to the table of its hour
+void YearColumns::AddHours(int month, std::size_t begin, std::size_t end) {
+    std::array<MonthAggregate, HOURS_PER_DAY>& hours = m_hourAggregates[month - 1];
+    for (std::size_t i = begin; i < end; ++i) {
+        const double values[METRIC_COUNT] = {m_windSpeed[i], m_temperature[i], m_solarRadiation[i]};
+        hours[HourOfDay(m_timestamps[i])].Add(values);
+    }
+}
+
+const MonthAggregate& YearColumns::Aggregate(int month) const {
+    static const MonthAggregate empty;
+    if (month < 1 || month > 12) {
+        return empty;
+    }
+    return m_monthAggregates[month - 1];
+}
+
+const MonthAggregate& YearColumns::HourAggregate(int month, int hour) const {
+    static const MonthAggregate empty;
+    if (month < 1 || month > 12 || hour < 0 || hour >= HOURS_PER_DAY) {
+        return empty;
+    }
+    return m_hourAggregates[month - 1][hour];
+}
+
+MonthData YearColumns::Row(std::size_t index) const {
+    MonthData row;
+    SplitTimestamp(m_timestamps[index], row.m_year, row.m_month, row.m_day);
+    row.m_hour = HourOfDay(m_timestamps[index]);
+    row.m_minute = MinuteOfDay(m_timestamps[index]) % 60;
+    row.m_windSpeed = m_windSpeed[index];
+    row.m_temperature = m_temperature[index];
+    row.m_solarRadiation = m_solarRadiation[index];
+    return row;
+}
+
+ColumnSpan YearColumns::Column(Metric metric) const {
+    switch (metric) {
+        case Metric::WindSpeed: return WindSpeed();
+        case Metric::Temperature: return Temperature();
+        case Metric::SolarRadiation: return SolarRadiation();
+    }
+    return ColumnSpan();
+}
+
+MonthData ReadingsView::Iterator::operator*() const {
+    return m_columns->Row(m_index);
+}
+
+MonthData ReadingsView::operator[](std::size_t index) const {
+    return m_columns->Row(m_begin + index);
+}
+
+Span<const Timestamp> ReadingsView::Timestamps() const {
+    return m_columns == nullptr ? Span<const Timestamp>() : m_columns->Timestamps().Subspan(m_begin, size());
+}
+
+ColumnSpan ReadingsView::WindSpeed() const {
+    return Column(Metric::WindSpeed);
+}
+
+ColumnSpan ReadingsView::Temperature() const {
+    return Column(Metric::Temperature);
+}
+
+ColumnSpan ReadingsView::SolarRadiation() const {
+    return Column(Metric::SolarRadiation);
+}
+
+ColumnSpan ReadingsView::Column(Metric metric) const {
+    return m_columns == nullptr ? ColumnSpan() : m_columns->Column(metric).Subspan(m_begin, size());
+}
@@ -0,0 +1,321 @@
+#ifndef YEARCOLUMNS_H
+#define YEARCOLUMNS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "MetricColumn.h"
+#include "StatsAccumulator.h"
+#include "Span.h"
+#include "TimeIndex.h"
+#include "Timestamp.h"
+
+struct MonthData;
+class ReadingsView;
+
+/**
+ * @brief What to do with readings that share the same timestamp.
+ *
+ * Overlapping source files repeat the readings they have in common. KeepFirst keeps the
+ * reading loaded first, KeepLast keeps the reading loaded last, and KeepAll keeps every
+ * copy, as the loader did before duplicates were detected.
+ */
+enum class DuplicatePolicy {
+    KeepFirst,
+    KeepLast,
+    KeepAll
+};
+
+/**
+ * @brief The readings of one year stored as columns (structure of arrays).
+ *
+ * Each reading is split across four parallel arrays: its timestamp, wind speed, temperature
+ * and solar radiation. A statistic over one metric then reads one contiguous array of
+ * doubles instead of striding over whole records. The loader keeps the columns sorted by
+ * timestamp, so every month is a contiguous run of rows, and records where each run starts
+ * in a month index. The statistics of every month, and of every hour of the day within each
+ * month, are computed when the year is loaded.
+ *
+ * The metric columns hold doubles until Compact is called. In compact storage every reading
+ * takes a 32-bit timestamp and a 16-bit or 32-bit fixed-point value per metric (see
+ * MetricColumn), and the columns are read back as the same doubles.
+ */
+class YearColumns {
+private:
+    std::vector<Timestamp> m_timestamps; // The time of each reading, in time order once sorted
+    MetricColumn m_windSpeed; // The wind speed of each reading in km/h
+    MetricColumn m_temperature; // The temperature of each reading in degrees C
+    MetricColumn m_solarRadiation; // The solar radiation of each reading in W/m2
+    std::array<std::uint32_t, 13> m_monthStart; // Month m holds rows [m_monthStart[m - 1], m_monthStart[m])
+    TimeIndex m_timeIndex; // The search index over m_timestamps, built with the month index
+    std::array<MonthAggregate, 12> m_monthAggregates; // The statistics of each month, January first
+    std::array<std::array<MonthAggregate, HOURS_PER_DAY>, 12> m_hourAggregates; // The statistics of each hour of the day in each month
+
+    /**
+     * @brief Add rows of one month to the statistics of their hours of the day.
+     *
+     * @param month The month of the rows (1-12).
+     * @param begin The first row.
+     * @param end One past the last row.
+     */
+    void AddHours(int month, std::size_t begin, std::size_t end);
+
+public:
+    /**
+     * @brief Construct an empty year.
+     */
+    YearColumns();
+
+    /**
+     * @brief Get the number of readings.
+     * @return std::size_t The row count.
+     */
+    std::size_t Size() const { return m_timestamps.size(); }
+
+    /**
+     * @brief Check if the year holds no readings.
+     * @return true If there are no rows.
+     */
+    bool Empty() const { return m_timestamps.empty(); }
+
+    /**
+     * @brief Reserve room for a number of readings in every column.
+     * @param rows The total number of rows to reserve.
+     */
+    void Reserve(std::size_t rows);
+
+    /**
+     * @brief Append one reading. The date of the record must be valid (see IsValidDate).
+     * @param row The reading to be appended.
+     */
+    void Append(const MonthData& row);
+
+    /**
+     * @brief Append every reading of another year, leaving it empty.
+     * @param other The columns to be moved to the end of this year.
+     */
+    void Append(YearColumns& other);
+
+    /**
+     * @brief Append every reading of another year that lies after the current last reading.
+     *
+     * The rows of the other year must be in time order and must not be earlier than the
+     * last row of this year. The month index is then updated and only the new rows are
+     * added to the monthly statistics, so the cost depends on the number of new rows.
+     * If the rows are not in order, nothing is changed.
+     *
+     * @param other The columns to be moved to the end of this year. It is left empty on success.
+     * @param strictlyAfter True if the first new row must be later than the last row, so that
+     * no timestamp can be repeated across the two.
+     * @return true If the rows were appended.
+     * @return false If the rows are out of order and this year must be sorted and rebuilt instead.
+     */
+    bool Extend(YearColumns& other, bool strictlyAfter);
+
+    /**
+     * @brief Replace every reading with rows copied from raw columns.
+     *
+     * @param timestamps The time of each row.
+     * @param windSpeed The wind speed of each row.
+     * @param temperature The temperature of each row.
+     * @param solarRadiation The solar radiation of each row.
+     * @param rows The number of rows in each array.
+     */
+    void Assign(const Timestamp* timestamps, const double* windSpeed, const double* temperature, const double* solarRadiation, std::size_t rows);
+
+    /**
+     * @brief Store each metric column in the narrowest fixed-point encoding that keeps its values exact.
+     *
+     * Rows appended later are encoded as they arrive. A column with a value that cannot be
+     * encoded at its scale falls back to doubles until Compact is called again.
+     */
+    void Compact();
+
+    /**
+     * @brief Store every metric column as doubles again.
+     */
+    void Expand();
+
+    /**
+     * @brief Get the number of bytes allocated for the readings, not counting the month index and statistics.
+     * @return std::size_t The bytes held by the timestamp and metric columns.
+     */
+    std::size_t Bytes() const;
+
+    /**
+     * @brief Check if the rows are in time order.
+     * @return true If the timestamps never decrease.
+     */
+    bool IsSorted() const;
+
+    /**
+     * @brief Sort the rows by timestamp, keeping readings with equal timestamps in their current order.
+     */
+    void SortByTime();
+
+    /**
+     * @brief Remove rows whose timestamp repeats the one before. The rows must be sorted by time.
+     *
+     * Repeated timestamps are adjacent in sorted rows, so one linear pass finds them. The
+     * month index and statistics are not updated.
+     *
+     * @param policy Which of the rows with the same timestamp to keep.
+     * @return std::size_t The number of rows removed.
+     */
+    std::size_t RemoveDuplicates(DuplicatePolicy policy);
+
+    /**
+     * @brief Record where each month starts and build the search index over the timestamps. The rows must be sorted by time.
+     *
+     * The loader calls this after every load. Appending rows leaves the indexes stale until
+     * they are rebuilt.
+     */
+    void BuildMonthIndex();
+
+    /**
+     * @brief Get the readings of one month in O(1) from the month index.
+     *
+     * @param month The month (1-12).
+     * @return ReadingsView A view of the rows of that month, empty for an invalid month.
+     */
+    ReadingsView Month(int month) const;
+
+    /**
+     * @brief Find the first reading at or after a time in O(log n) with the search index.
+     *
+     * @param value The time to be found.
+     * @return std::size_t The index of the first row whose timestamp is not less than value, or Size() if there is none.
+     */
+    std::size_t LowerBound(Timestamp value) const;
+
+    /**
+     * @brief Get the readings taken in a period.
+     *
+     * @param from The start of the period.
+     * @param to The end of the period, not included.
+     * @return ReadingsView A view of the rows with from <= timestamp < to, empty if there are none.
+     */
+    ReadingsView Period(Timestamp from, Timestamp to) const;
+
+    /**
+     * @brief Compute the statistics of every month, and of every hour of the day in each month, in one pass over the year.
+     *
+     * The month index must be up to date. The loader calls this after BuildMonthIndex.
+     */
+    void BuildAggregates();
+
+    /**
+     * @brief Get the precomputed statistics of one month.
+     *
+     * @param month The month (1-12).
+     * @return const MonthAggregate& The statistics, with a count of 0 for an invalid or empty month.
+     */
+    const MonthAggregate& Aggregate(int month) const;
+
+    /**
+     * @brief Get the precomputed statistics of one hour of the day over a month.
+     *
+     * The readings of the hour are those from hour:00 up to but not including (hour + 1):00
+     * on every day of the month.
+     *
+     * @param month The month (1-12).
+     * @param hour The hour of the day (0-23).
+     * @return const MonthAggregate& The statistics, with a count of 0 for an invalid or empty month or hour.
+     */
+    const MonthAggregate& HourAggregate(int month, int hour) const;
+
+    /**
+     * @brief Rebuild one reading as a MonthData record.
+     *
+     * @param index The row index.
+     * @return MonthData The reading at that row.
+     */
+    MonthData Row(std::size_t index) const;
+
+    Span<const Timestamp> Timestamps() const { return Span<const Timestamp>(m_timestamps); }
+    ColumnSpan WindSpeed() const { return ColumnSpan(m_windSpeed); }
+    ColumnSpan Temperature() const { return ColumnSpan(m_temperature); }
+    ColumnSpan SolarRadiation() const { return ColumnSpan(m_solarRadiation); }
+
+    /**
+     * @brief Get the column of one metric.
+     * @param metric The metric to be read.
+     * @return ColumnSpan The values of that metric for every row.
+     */
+    ColumnSpan Column(Metric metric) const;
+};
+
+/**
+ * @brief A non-owning, read-only view of a run of rows [begin, end) of a YearColumns.
+ *
+ * The view exposes each metric as a column span, and can also be iterated as MonthData
+ * records, which are rebuilt on the fly. It must not outlive the data it was taken from.
+ */
+class ReadingsView {
+private:
+    const YearColumns* m_columns; // The year the rows belong to (nullptr for an empty view)
+    std::size_t m_begin; // The first row of the view
+    std::size_t m_end; // One past the last row of the view
+
+public:
+    /**
+     * @brief An iterator that yields the readings of the view as MonthData records.
+     */
+    class Iterator {
+    private:
+        const YearColumns* m_columns;
+        std::size_t m_index;
+
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef MonthData value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const MonthData* pointer;
+        typedef MonthData reference;
+
+        Iterator(const YearColumns* columns, std::size_t index) : m_columns(columns), m_index(index) {}
+        MonthData operator*() const;
+        Iterator& operator++() { ++m_index; return *this; }
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+    };
+
+    /**
+     * @brief Construct an empty view.
+     */
+    ReadingsView() : m_columns(nullptr), m_begin(0), m_end(0) {}
+
+    /**
+     * @brief Construct a view of the rows [begin, end) of a year.
+     */
+    ReadingsView(const YearColumns& columns, std::size_t begin, std::size_t end)
+        : m_columns(&columns), m_begin(begin), m_end(end) {}
+
+    std::size_t size() const { return m_end - m_begin; }
+    bool empty() const { return m_begin == m_end; }
+    Iterator begin() const { return Iterator(m_columns, m_begin); }
+    Iterator end() const { return Iterator(m_columns, m_end); }
+
+    /**
+     * @brief Rebuild one reading of the view as a MonthData record.
+     * @param index The position in the view.
+     * @return MonthData The reading.
+     */
+    MonthData operator[](std::size_t index) const;
+
+    Span<const Timestamp> Timestamps() const;
+    ColumnSpan WindSpeed() const;
+    ColumnSpan Temperature() const;
+    ColumnSpan SolarRadiation() const;
+
+    /**
+     * @brief Get the values of one metric for the rows of the view.
+     * @param metric The metric to be read.
+     * @return ColumnSpan The values, read as doubles.
+     */
+    ColumnSpan Column(Metric metric) const;
+};
+
+#endif // YEARCOLUMNS_H